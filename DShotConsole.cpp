@@ -0,0 +1,413 @@
+//
+// Name:        DShotConsole.cpp
+// Created: 	18.10.2026 14:12:40
+// Author:  	derdoktor667
+//
+
+#include <DShotConsole.h>
+
+DShotConsole::DShotConsole(DShotRMT &motor, Stream &stream)
+    : motor(motor),
+      stream(stream),
+      report_queue(nullptr),
+      output_task(nullptr),
+      exit_task(nullptr),
+      line{},
+      line_length(0),
+      is_line_overflow(false),
+      is_throttle_override(false),
+      ramp_from(DSHOT_THROTTLE_MIN),
+      ramp_to(DSHOT_THROTTLE_MIN),
+      ramp_start_ms(0),
+      ramp_duration_ms(0),
+      watch_interval_ms(0),
+      watch_last_ms(0),
+      bench_frames(0),
+      bench_frames_sent(0),
+      is_bench_rate_pass(false),
+      bench_send_cycles(0),
+      bench_rate_us(0)
+{
+}
+
+DShotConsole::~DShotConsole()
+{
+    // Let the output task end itself, it may be printing and hold the stream
+    if (output_task != nullptr)
+    {
+        dshot_console_report_data_t report_data = {};
+        report_data.report = REPORT_EXIT;
+        exit_task = xTaskGetCurrentTaskHandle();
+
+        xQueueSendToBack(report_queue, &report_data, portMAX_DELAY);
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+
+    if (report_queue != nullptr)
+    {
+        vQueueDelete(report_queue);
+    }
+}
+
+bool DShotConsole::begin()
+{
+    // Already running
+    if (output_task != nullptr)
+    {
+        return true;
+    }
+
+    if (report_queue == nullptr)
+    {
+        report_queue = xQueueCreate(DSHOT_CONSOLE_REPORT_QUEUE_LENGTH, sizeof(dshot_console_report_data_t));
+    }
+
+    if (report_queue == nullptr)
+    {
+        return false;
+    }
+
+#if CONFIG_FREERTOS_UNICORE
+    return (xTaskCreate(outputTask, "DShotConsole", DSHOT_CONSOLE_TASK_STACK_SIZE, this, DSHOT_CONSOLE_TASK_PRIORITY, &output_task) == pdPASS);
+#else
+    return (xTaskCreatePinnedToCore(outputTask, "DShotConsole", DSHOT_CONSOLE_TASK_STACK_SIZE, this, DSHOT_CONSOLE_TASK_PRIORITY, &output_task, DSHOT_CONSOLE_TASK_CORE) == pdPASS);
+#endif
+}
+
+// Parses the bytes received so far, never waits for more
+void DShotConsole::update()
+{
+    for (int i = 0; (i < DSHOT_CONSOLE_BYTES_PER_UPDATE) && (stream.available() > 0); i++)
+    {
+        const int received = stream.read();
+
+        // Run the command at the end of a line
+        if ((received == '\n') || (received == '\r'))
+        {
+            line[line_length] = '\0';
+
+            if (is_line_overflow)
+            {
+                postReport(REPORT_ERROR);
+            }
+            else if (line_length > 0)
+            {
+                runCommand(line);
+            }
+
+            line_length = 0;
+            is_line_overflow = false;
+        }
+        else if (line_length < DSHOT_CONSOLE_LINE_LENGTH)
+        {
+            line[line_length++] = static_cast<char>(received);
+        }
+        else
+        {
+            is_line_overflow = true;
+        }
+    }
+
+    // Periodic stats while watching
+    if ((watch_interval_ms > 0) && ((millis() - watch_last_ms) >= watch_interval_ms))
+    {
+        watch_last_ms = millis();
+        postReport(REPORT_STATS);
+    }
+
+    // A running benchmark continues with a few frames per call
+    if (bench_frames > 0)
+    {
+        runBenchmarkStep();
+    }
+}
+
+// Returns the throttle while the console has taken it over
+bool DShotConsole::getThrottle(uint16_t &throttle_value) const
+{
+    if (!is_throttle_override)
+    {
+        return false;
+    }
+
+    const uint32_t elapsed_ms = millis() - ramp_start_ms;
+
+    // Fixed throttle or ramp finished
+    if (elapsed_ms >= ramp_duration_ms)
+    {
+        throttle_value = ramp_to;
+    }
+    else
+    {
+        throttle_value = ramp_from + ((static_cast<int32_t>(ramp_to) - ramp_from) * static_cast<int32_t>(elapsed_ms)) / static_cast<int32_t>(ramp_duration_ms);
+    }
+
+    return true;
+}
+
+// Parses and runs a complete command line
+void DShotConsole::runCommand(char *command_line)
+{
+    char *save_ptr = nullptr;
+    const char *command = strtok_r(command_line, " \t", &save_ptr);
+    int32_t args[3] = {};
+    uint8_t arg_count = 0;
+
+    // Every argument is a number
+    for (char *arg = strtok_r(nullptr, " \t", &save_ptr); (arg != nullptr) && (arg_count < 3); arg = strtok_r(nullptr, " \t", &save_ptr))
+    {
+        args[arg_count++] = strtol(arg, nullptr, 10);
+    }
+
+    if (command == nullptr)
+    {
+        return;
+    }
+
+    if (strcmp(command, "help") == 0)
+    {
+        postReport(REPORT_HELP);
+    }
+    else if (strcmp(command, "stats") == 0)
+    {
+        postReport(REPORT_STATS);
+    }
+    else if (strcmp(command, "telemetry") == 0)
+    {
+        postReport(REPORT_TELEMETRY);
+    }
+    else if ((strcmp(command, "watch") == 0) && (arg_count == 1) && (args[0] >= 0))
+    {
+        watch_interval_ms = args[0];
+        watch_last_ms = millis();
+    }
+    else if ((strcmp(command, "mode") == 0) && (arg_count >= 1) && (args[0] >= DSHOT_OFF) && (args[0] <= DSHOT1200))
+    {
+        // Reinstalls the RMT channel with the new mode, a running benchmark would mix both modes
+        bench_frames = 0;
+        const bool is_success = motor.begin(static_cast<dshot_mode_t>(args[0]), (args[1] != 0));
+        postReport(REPORT_MODE, is_success);
+    }
+    else if ((strcmp(command, "cmd") == 0) && (arg_count >= 1) && (args[0] >= DSHOT_CMD_MOTOR_STOP) && (args[0] <= DSHOT_CMD_MAX))
+    {
+        const int32_t repeat = (arg_count > 1) ? constrain(args[1], 1, DSHOT_CONSOLE_COMMAND_REPEAT_MAX) : 1;
+
+        // Sent back to back, so the ESC sees the repeats without throttle frames in between
+        for (int32_t i = 0; i < repeat; i++)
+        {
+            motor.sendCommand(static_cast<dshot_cmd_t>(args[0]));
+        }
+
+        postReport(REPORT_COMMAND, args[0], repeat);
+    }
+    else if ((strcmp(command, "throttle") == 0) && (arg_count == 1))
+    {
+        ramp_from = ramp_to = constrain(args[0], DSHOT_THROTTLE_MIN, DSHOT_THROTTLE_MAX);
+        ramp_duration_ms = 0;
+        is_throttle_override = true;
+
+        postReport(REPORT_RAMP, ramp_from, ramp_to, 0);
+    }
+    else if ((strcmp(command, "ramp") == 0) && (arg_count == 3) && (args[2] >= 0))
+    {
+        ramp_from = constrain(args[0], DSHOT_THROTTLE_MIN, DSHOT_THROTTLE_MAX);
+        ramp_to = constrain(args[1], DSHOT_THROTTLE_MIN, DSHOT_THROTTLE_MAX);
+        ramp_duration_ms = args[2];
+        ramp_start_ms = millis();
+        is_throttle_override = true;
+
+        postReport(REPORT_RAMP, ramp_from, ramp_to, ramp_duration_ms);
+    }
+    else if (strcmp(command, "stop") == 0)
+    {
+        is_throttle_override = false;
+        watch_interval_ms = 0;
+        bench_frames = 0;
+    }
+    else if (strcmp(command, "bench") == 0)
+    {
+        // The application keeps its throttle, only the console throttle is benchmarked
+        if (!is_throttle_override)
+        {
+            postReport(REPORT_BENCHMARK_REFUSED);
+        }
+        else
+        {
+            bench_frames = (arg_count > 0) ? constrain(args[0], 1, DSHOT_CONSOLE_BENCHMARK_FRAMES_MAX) : DSHOT_CONSOLE_BENCHMARK_FRAMES;
+            bench_frames_sent = 0;
+            is_bench_rate_pass = false;
+            bench_send_cycles = 0;
+            bench_rate_us = 0;
+        }
+    }
+    else
+    {
+        postReport(REPORT_ERROR);
+    }
+}
+
+// Sends the next frames of a running benchmark, first the CPU cost pass, then the frame rate pass
+void DShotConsole::runBenchmarkStep()
+{
+    uint16_t throttle_value = DSHOT_THROTTLE_MIN;
+
+    if (!getThrottle(throttle_value))
+    {
+        bench_frames = 0;
+        return;
+    }
+
+    const int32_t chunk = min(static_cast<int32_t>(DSHOT_CONSOLE_BENCHMARK_FRAMES_PER_UPDATE), bench_frames - bench_frames_sent);
+
+    if (!is_bench_rate_pass)
+    {
+        // CPU cost of a send, the channel is idle before each one
+        for (int32_t i = 0; i < chunk; i++)
+        {
+            motor.waitTxDone();
+
+            const uint32_t start_cycles = ESP.getCycleCount();
+            motor.sendThrottleValue(throttle_value);
+            bench_send_cycles += ESP.getCycleCount() - start_cycles;
+        }
+    }
+    else
+    {
+        // Frame rate of back to back sends, the frames of the application loop in between are not timed
+        motor.waitTxDone();
+        const uint32_t start_us = micros();
+
+        for (int32_t i = 0; i < chunk; i++)
+        {
+            motor.sendThrottleValue(throttle_value);
+        }
+
+        motor.waitTxDone();
+        bench_rate_us += micros() - start_us;
+    }
+
+    bench_frames_sent += chunk;
+
+    if (bench_frames_sent < bench_frames)
+    {
+        return;
+    }
+
+    if (!is_bench_rate_pass)
+    {
+        is_bench_rate_pass = true;
+        bench_frames_sent = 0;
+        return;
+    }
+
+    postReport(REPORT_BENCHMARK, bench_frames, bench_send_cycles / bench_frames,
+               (static_cast<uint64_t>(bench_frames) * 1000000) / max(bench_rate_us, static_cast<uint32_t>(1)));
+    bench_frames = 0;
+}
+
+// Takes a snapshot for the output task, drops the report if the queue is full
+void DShotConsole::postReport(dshot_console_report_t report, int32_t value0, int32_t value1, int32_t value2)
+{
+    if (report_queue == nullptr)
+    {
+        return;
+    }
+
+    dshot_console_report_data_t report_data = {};
+
+    report_data.report = report;
+    report_data.mode = motor.getMode();
+    report_data.is_bidirectional = motor.isBidirectional();
+    report_data.limiter_stats = motor.getLimiterStats();
+    report_data.timing_calibration = motor.getTimingCalibration();
+    report_data.values[0] = value0;
+    report_data.values[1] = value1;
+    report_data.values[2] = value2;
+
+    xQueueSend(report_queue, &report_data, 0);
+}
+
+// Formats a report, only called by the output task
+void DShotConsole::printReport(const dshot_console_report_data_t &report_data)
+{
+    switch (report_data.report)
+    {
+    case REPORT_HELP:
+        stream.println("help | stats | telemetry | watch <ms> | mode <0-4> [0|1] | cmd <0-47> [repeat]");
+        stream.println("throttle <48-2047> | ramp <from> <to> <ms> | stop | bench [frames]");
+        break;
+
+    case REPORT_STATS:
+        stream.printf("mode: %s%s\n", dshot_mode_name[report_data.mode], report_data.is_bidirectional ? " bidirectional" : "");
+        stream.printf("limiter: scale %u/%d, frames limited %" PRIu32 "\n",
+                      report_data.limiter_stats.throttle_scale, DSHOT_LIMITER_SCALE_FULL, report_data.limiter_stats.frames_limited);
+
+        if (report_data.timing_calibration.is_valid)
+        {
+            stream.printf("timing error ns: zero %d/%d, one %d/%d (%u frames)\n",
+                          report_data.timing_calibration.zero_high_error_ns, report_data.timing_calibration.zero_low_error_ns,
+                          report_data.timing_calibration.one_high_error_ns, report_data.timing_calibration.one_low_error_ns,
+                          report_data.timing_calibration.frames_measured);
+        }
+        else
+        {
+            stream.println("timing: not calibrated");
+        }
+        break;
+
+    case REPORT_TELEMETRY:
+        stream.printf("telemetry: %u.%02u A, %u C\n",
+                      report_data.limiter_stats.current / 100, report_data.limiter_stats.current % 100, report_data.limiter_stats.temperature);
+        break;
+
+    case REPORT_MODE:
+        stream.printf("mode: %s%s %s\n", dshot_mode_name[report_data.mode], report_data.is_bidirectional ? " bidirectional" : "",
+                      report_data.values[0] ? "ok" : "failed");
+        break;
+
+    case REPORT_COMMAND:
+        stream.printf("cmd: %" PRId32 " sent %" PRId32 "x\n", report_data.values[0], report_data.values[1]);
+        break;
+
+    case REPORT_RAMP:
+        stream.printf("throttle: %" PRId32 " -> %" PRId32 " in %" PRId32 " ms\n", report_data.values[0], report_data.values[1], report_data.values[2]);
+        break;
+
+    case REPORT_BENCHMARK:
+        stream.printf("bench: %" PRId32 " frames, %" PRId32 " cycles/send, %" PRId32 " frames/s\n", report_data.values[0], report_data.values[1], report_data.values[2]);
+        break;
+
+    case REPORT_BENCHMARK_REFUSED:
+        stream.println("bench: take over the throttle first, e.g. throttle 48");
+        break;
+
+    // Unknown command or invalid arguments
+    default:
+        stream.println("error: unknown command, try help");
+        break;
+    }
+}
+
+// Prints queued reports at a limited rate, so the output never competes with the frame loop
+void DShotConsole::outputTask(void *console)
+{
+    DShotConsole *const dshot_console = static_cast<DShotConsole *>(console);
+    dshot_console_report_data_t report_data;
+
+    for (;;)
+    {
+        if (xQueueReceive(dshot_console->report_queue, &report_data, portMAX_DELAY) == pdTRUE)
+        {
+            // The destructor waits for this, nothing is printing anymore
+            if (report_data.report == REPORT_EXIT)
+            {
+                xTaskNotifyGive(dshot_console->exit_task);
+                vTaskDelete(nullptr);
+            }
+
+            dshot_console->printReport(report_data);
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(DSHOT_CONSOLE_OUTPUT_INTERVAL_MS));
+    }
+}
@@ -0,0 +1,123 @@
+//
+// Name:        DShotConsole.h
+// Created: 	18.10.2026 14:12:40
+// Author:  	derdoktor667
+//
+
+#ifndef _DSHOTCONSOLE_h
+#define _DSHOTCONSOLE_h
+
+#include <Arduino.h>
+#include <inttypes.h>
+#include <DShotRMT.h>
+
+// Constants related to the diagnostics console
+constexpr auto DSHOT_CONSOLE_LINE_LENGTH = 48;                // Longest command line, longer lines are dropped
+constexpr auto DSHOT_CONSOLE_BYTES_PER_UPDATE = 32;           // Bytes parsed per update() call at most
+constexpr auto DSHOT_CONSOLE_REPORT_QUEUE_LENGTH = 8;         // Reports waiting for output, further reports are dropped
+constexpr auto DSHOT_CONSOLE_OUTPUT_INTERVAL_MS = 20;         // Minimum time between two reports on the stream
+constexpr auto DSHOT_CONSOLE_TASK_STACK_SIZE = 3072;
+constexpr auto DSHOT_CONSOLE_BENCHMARK_FRAMES = 1000;         // Default number of frames of a benchmark run
+constexpr auto DSHOT_CONSOLE_BENCHMARK_FRAMES_MAX = 10000;    // Keeps a benchmark run short
+constexpr auto DSHOT_CONSOLE_BENCHMARK_FRAMES_PER_UPDATE = 4; // Benchmark frames sent per update() call at most
+constexpr auto DSHOT_CONSOLE_COMMAND_REPEAT_MAX = 10;
+
+// The output task runs on the core without the frame loop, on single core chips
+// it runs below the priority of the Arduino loop task
+#if CONFIG_FREERTOS_UNICORE
+constexpr auto DSHOT_CONSOLE_TASK_PRIORITY = tskIDLE_PRIORITY;
+#else
+constexpr auto DSHOT_CONSOLE_TASK_PRIORITY = (tskIDLE_PRIORITY + 1);
+constexpr auto DSHOT_CONSOLE_TASK_CORE = (ARDUINO_RUNNING_CORE == 0) ? 1 : 0;
+#endif
+
+// Kind of report passed to the output task
+typedef enum dshot_console_report_e
+{
+    REPORT_HELP,
+    REPORT_STATS,
+    REPORT_TELEMETRY,
+    REPORT_MODE,
+    REPORT_COMMAND,
+    REPORT_RAMP,
+    REPORT_BENCHMARK,
+    REPORT_BENCHMARK_REFUSED,
+    REPORT_ERROR,
+    REPORT_EXIT, // Ends the output task
+} dshot_console_report_t;
+
+// Snapshot of everything a report may show, formatted by the output task
+typedef struct dshot_console_report_data_s
+{
+    dshot_console_report_t report;
+    dshot_mode_t mode;
+    bool is_bidirectional;
+    dshot_limiter_stats_t limiter_stats;
+    dshot_timing_calibration_t timing_calibration;
+    int32_t values[3]; // Report specific values, e.g. command and repeat count
+} dshot_console_report_data_t;
+
+// Optional serial console for live inspection and control of a motor.
+// update() only parses the bytes already received and never blocks the frame
+// loop, all output is formatted and printed by a low priority task.
+class DShotConsole
+{
+public:
+    DShotConsole(DShotRMT &motor, Stream &stream);
+    ~DShotConsole();
+
+    // The begin() function starts the output task. It returns a boolean value
+    // indicating whether or not the task could be created.
+    bool begin();
+
+    // The update() function has to be called from the frame loop. It parses up
+    // to DSHOT_CONSOLE_BYTES_PER_UPDATE received bytes and runs complete commands:
+    //   help                     - list all commands
+    //   stats                    - show mode, limiter and timing calibration
+    //   telemetry                - show the last telemetry passed to the limiter
+    //   watch <ms>               - show stats periodically, 0 stops
+    //   mode <0-4> [0|1]         - begin the motor with a dshot_mode_t, optionally bidirectional
+    //   cmd <0-47> [repeat]      - send a dshot_cmd_t, e.g. 6x for settings
+    //   throttle <48-2047>       - take over the throttle
+    //   ramp <from> <to> <ms>    - take over the throttle with a linear ramp
+    //   stop                     - hand the throttle back to the application
+    //   bench [frames]           - measure CPU cycles per send and frame rate, up to 10000 frames,
+    //                              only while the console has taken over the throttle
+    void update();
+
+    // The getThrottle() function returns true while the console has taken over
+    // the throttle and sets throttle_value to the value to send.
+    bool getThrottle(uint16_t &throttle_value) const;
+
+private:
+    DShotRMT &motor;                          // The motor inspected and controlled.
+    Stream &stream;                           // The stream commands are read from and reports are written to.
+    QueueHandle_t report_queue;               // Reports waiting for the output task.
+    TaskHandle_t output_task;                 // The low priority output task.
+    TaskHandle_t exit_task;                   // The task waiting for the output task to end.
+    char line[DSHOT_CONSOLE_LINE_LENGTH + 1]; // The command line received so far.
+    uint8_t line_length;                      // Number of characters in line.
+    bool is_line_overflow;                    // Whether the current line is too long.
+    bool is_throttle_override;                // Whether the console has taken over the throttle.
+    uint16_t ramp_from;                       // Throttle at the start of the ramp.
+    uint16_t ramp_to;                         // Throttle at the end of the ramp.
+    uint32_t ramp_start_ms;                   // Start time of the ramp.
+    uint32_t ramp_duration_ms;                // Duration of the ramp, 0 for a fixed throttle.
+    uint32_t watch_interval_ms;               // Interval of periodic stats, 0 when off.
+    uint32_t watch_last_ms;                   // Time of the last periodic stats.
+    int32_t bench_frames;                     // Frames per pass of the running benchmark, 0 when idle.
+    int32_t bench_frames_sent;                // Frames sent in the current pass.
+    bool is_bench_rate_pass;                  // Whether the frame rate pass runs, otherwise the CPU cost pass.
+    uint64_t bench_send_cycles;               // CPU cycles of all timed sends.
+    uint32_t bench_rate_us;                   // Duration of all back to back chunks.
+
+    void runCommand(char *command_line);                              // Parses and runs a complete command line.
+    void runBenchmarkStep();                                          // Sends the next few frames of a running benchmark.
+    void printReport(const dshot_console_report_data_t &report_data); // Formats a report, output task only.
+    static void outputTask(void *console);                            // Prints queued reports at a limited rate.
+
+    // Takes a snapshot of the motor and queues a report without waiting.
+    void postReport(dshot_console_report_t report, int32_t value0 = 0, int32_t value1 = 0, int32_t value2 = 0);
+};
+
+#endif
@@ -6,64 +6,79 @@
 
 #include <DShotRMT.h>
 
-// Constructor that takes gpio and rmtChannel as arguments
-DShotRMT::DShotRMT(gpio_num_t gpio, rmt_channel_t rmtChannel)
+DShotRMT::~DShotRMT()
 {
-    // Initialize the dshot_config structure with the arguments passed to the constructor
-    dshot_config.gpio_num = gpio;
-    dshot_config.pin_num = static_cast<uint8_t>(gpio);
-    dshot_config.rmt_channel = rmtChannel;
-    dshot_config.mem_block_num = static_cast<uint8_t>(RMT_CHANNEL_MAX - static_cast<uint8_t>(rmtChannel));
-
-    // Create an empty packet using the DSHOT_NULL_PACKET and the buildTxRmtItem function
-    buildTxRmtItem(DSHOT_NULL_PACKET);
+    // Uninstall the RMT driver
+    end();
 }
 
-// Constructor that takes pin and channel as arguments
-DShotRMT::DShotRMT(uint8_t pin, uint8_t channel)
+DShotRMT::DShotRMT(DShotRMT const &other)
+    : dshot_tx_rmt_item{},
+      dshot_tx_rmt_config(other.dshot_tx_rmt_config),
+      dshot_config(other.dshot_config),
+      dshot_timing_calibration(other.dshot_timing_calibration),
+      throttle_map(other.throttle_map),
+      deadband_3d(other.deadband_3d),
+      rotation_direction(0),
+      reversal_erpm(other.reversal_erpm),
+      dshot_limiter_config(other.dshot_limiter_config),
+      dshot_limiter_stats(other.dshot_limiter_stats),
+      is_installed(false)
 {
-    // Initialize the dshot_config structure with the arguments passed to the constructor
-    dshot_config.gpio_num = static_cast<gpio_num_t>(pin);
-    dshot_config.pin_num = pin;
-    dshot_config.rmt_channel = static_cast<rmt_channel_t>(channel);
-    dshot_config.mem_block_num = RMT_CHANNEL_MAX - channel;
-
-    // Create an empty packet using the DSHOT_NULL_PACKET and the buildTxRmtItem function
-    buildTxRmtItem(DSHOT_NULL_PACKET);
+    // The RMT channel belongs to the original, so only the settings are copied
 }
 
-// ...simplest but only for testing
-DShotRMT::DShotRMT(uint8_t pin)
+bool DShotRMT::begin(dshot_mode_t dshot_mode, bool is_bidirectional)
 {
-    // Initialize the dshot_config structure with the arguments passed to the constructor
-    dshot_config.gpio_num = static_cast<gpio_num_t>(pin);
-    dshot_config.pin_num = pin;
-    dshot_config.rmt_channel = static_cast<rmt_channel_t>(RMT_CHANNEL_MAX -1);
-    dshot_config.mem_block_num = RMT_CHANNEL_MAX - 1;
+    setupConfig(dshot_mode, is_bidirectional);
 
-    // Create an empty packet using the DSHOT_NULL_PACKET and the buildTxRmtItem function
-    buildTxRmtItem(DSHOT_NULL_PACKET);
+    // Install RMT driver and return result
+    return installDriver();
 }
 
-DShotRMT::~DShotRMT()
+// Sets up all motors first and installs all RMT channels in one pass
+bool DShotRMT::beginGroup(DShotRMT *const motors[], uint8_t motor_count, dshot_mode_t dshot_mode, bool is_bidirectional)
 {
-    // Uninstall the RMT driver
-    rmt_driver_uninstall(dshot_config.rmt_channel);
+    for (uint8_t i = 0; i < motor_count; i++)
+    {
+        motors[i]->setupConfig(dshot_mode, is_bidirectional);
+    }
+
+    bool is_success = true;
+
+    for (uint8_t i = 0; i < motor_count; i++)
+    {
+        is_success &= motors[i]->installDriver();
+    }
+
+    return is_success;
 }
 
-DShotRMT::DShotRMT(DShotRMT const &)
+// Stops the output and releases the RMT channel
+void DShotRMT::end()
 {
-    // ...write me
+    if (is_installed)
+    {
+        rmt_driver_uninstall(dshot_config.rmt_channel);
+        is_installed = false;
+    }
 }
 
-bool DShotRMT::begin(dshot_mode_t dshot_mode, bool is_bidirectional)
+// Sets up the DShot mode and the RMT channel, no driver installed yet
+void DShotRMT::setupConfig(dshot_mode_t dshot_mode, bool is_bidirectional)
 {
+    // A running channel has to be reinstalled with the new settings
+    end();
+
     // Set DShot configuration parameters based on input parameters
     dshot_config.mode = dshot_mode;
     dshot_config.clk_div = DSHOT_CLK_DIVIDER;
     dshot_config.name_str = dshot_mode_name[dshot_mode];
     dshot_config.is_bidirectional = is_bidirectional;
 
+    // Timing calibration only applies to the tick values set below
+    dshot_timing_calibration = {};
+
     // Set timing parameters based on selected DShot mode
     switch (dshot_config.mode)
     {
@@ -126,15 +141,21 @@ bool DShotRMT::begin(dshot_mode_t dshot_mode, bool is_bidirectional)
     // Set up selected DShot mode
     rmt_config(&dshot_tx_rmt_config);
 
-    // Install RMT driver and return result
-    return rmt_driver_install(dshot_tx_rmt_config.channel, 0, 0);
+    // Create an empty packet with the timing of the selected mode
+    buildTxRmtItem(DSHOT_NULL_PACKET);
+}
+
+// Installs the RMT driver of the channel
+bool DShotRMT::installDriver()
+{
+    is_installed = (rmt_driver_install(dshot_tx_rmt_config.channel, 0, 0) == ESP_OK);
+
+    return is_installed;
 }
 
 // Define a function to send a DShot command over an RMT interface to control a brushless motor's speed.
 void DShotRMT::sendThrottleValue(uint16_t throttle_value)
 {
-    dshot_packet_t dshot_rmt_packet = {};
-
     // Check if the throttle value is less than the minimum allowed value for the DShot protocol.
     if (throttle_value < DSHOT_THROTTLE_MIN)
     {
@@ -147,10 +168,156 @@ void DShotRMT::sendThrottleValue(uint16_t throttle_value)
         throttle_value = DSHOT_THROTTLE_MAX;
     }
 
-    dshot_rmt_packet.throttle_value = throttle_value;
+    // Scale down the throttle value while the telemetry exceeds an envelope
+    if (dshot_limiter_stats.throttle_scale < DSHOT_LIMITER_SCALE_FULL)
+    {
+        throttle_value = DSHOT_THROTTLE_MIN + (((throttle_value - DSHOT_THROTTLE_MIN) * dshot_limiter_stats.throttle_scale) / DSHOT_LIMITER_SCALE_FULL);
+        dshot_limiter_stats.frames_limited++;
+    }
+
+    // Remap the throttle value, a single table lookup per frame
+    if (throttle_map != nullptr)
+    {
+        throttle_value = throttle_map[throttle_value - DSHOT_THROTTLE_MIN];
+    }
 
     // Telemetric using additional pin on the ESC is not supported.
-    dshot_rmt_packet.telemetric_request = NO_TELEMETRIC;
+    sendDShotValue(throttle_value, NO_TELEMETRIC);
+}
+
+// Maps a signed throttle value onto the split 3D throttle range
+void DShotRMT::sendThrottle3D(int16_t throttle_value)
+{
+    // Check if the throttle value exceeds the signed 3D range in either direction.
+    throttle_value = constrain(throttle_value, -DSHOT_3D_THROTTLE_SIGNED_MAX, DSHOT_3D_THROTTLE_SIGNED_MAX);
+
+    // Scale down the throttle value in both directions while the telemetry exceeds an envelope
+    if (dshot_limiter_stats.throttle_scale < DSHOT_LIMITER_SCALE_FULL)
+    {
+        throttle_value = (throttle_value * dshot_limiter_stats.throttle_scale) / DSHOT_LIMITER_SCALE_FULL;
+        dshot_limiter_stats.frames_limited++;
+    }
+
+    const uint16_t magnitude = abs(throttle_value);
+
+    // Stop the motor within the deadband
+    if (magnitude <= deadband_3d)
+    {
+        sendDShotValue(DSHOT_CMD_MOTOR_STOP, NO_TELEMETRIC);
+        return;
+    }
+
+    // Scale the range above the deadband, so the slowest speed follows right after it
+    const uint32_t step = magnitude - deadband_3d - 1;
+    const uint32_t steps = DSHOT_3D_THROTTLE_SIGNED_MAX - deadband_3d - 1;
+
+    if (throttle_value > 0)
+    {
+        sendDShotValue(DSHOT_3D_THROTTLE_FORWARD_MIN + (step * (DSHOT_3D_THROTTLE_FORWARD_MAX - DSHOT_3D_THROTTLE_FORWARD_MIN)) / steps, NO_TELEMETRIC);
+        rotation_direction = 1;
+    }
+    else
+    {
+        sendDShotValue(DSHOT_3D_THROTTLE_REVERSE_MIN + (step * (DSHOT_3D_THROTTLE_REVERSE_MAX - DSHOT_3D_THROTTLE_REVERSE_MIN)) / steps, NO_TELEMETRIC);
+        rotation_direction = -1;
+    }
+}
+
+// Sends a signed 3D throttle value, a change of direction waits for the motor to slow down
+void DShotRMT::sendThrottle3D(int16_t throttle_value, uint32_t erpm)
+{
+    const int32_t deadband = deadband_3d;
+    const int8_t direction = (throttle_value > deadband) ? 1 : ((throttle_value < -deadband) ? -1 : 0);
+
+    // Driving against a fast rotation stresses the ESC and may desync the motor, neutral lets it slow down first
+    if ((direction != 0) && (rotation_direction != 0) && (direction != rotation_direction) && (erpm > reversal_erpm))
+    {
+        throttle_value = 0;
+    }
+
+    sendThrottle3D(throttle_value);
+}
+
+// Sets the neutral deadband of the signed 3D throttle
+void DShotRMT::set3DDeadband(uint16_t deadband)
+{
+    // At least the slowest and the full speed have to remain on each side of the deadband
+    deadband_3d = min(deadband, static_cast<uint16_t>(DSHOT_3D_THROTTLE_SIGNED_MAX - 2));
+}
+
+// Sets the eRPM up to which a change of direction is sent right away
+void DShotRMT::setReversalThreshold(uint32_t erpm)
+{
+    reversal_erpm = erpm;
+}
+
+// Calculates the throttle scale of a single envelope
+static uint16_t calculateLimiterScale(uint16_t value, uint16_t soft_limit, uint16_t hard_limit)
+{
+    // Envelope disabled
+    if (hard_limit == 0)
+    {
+        return DSHOT_LIMITER_SCALE_FULL;
+    }
+
+    // Hard limit reached, only the minimum throttle remains, even if the soft limit is the same
+    if (value >= hard_limit)
+    {
+        return 0;
+    }
+
+    // Soft limit not exceeded
+    if (value <= soft_limit)
+    {
+        return DSHOT_LIMITER_SCALE_FULL;
+    }
+
+    // Scale down linearly between the soft and the hard limit
+    return DSHOT_LIMITER_SCALE_FULL - ((static_cast<uint32_t>(value - soft_limit) * DSHOT_LIMITER_SCALE_FULL) / (hard_limit - soft_limit));
+}
+
+// Sets the envelopes of the telemetry limiter
+void DShotRMT::setLimiter(const dshot_limiter_config_t &limiter_config)
+{
+    dshot_limiter_config = limiter_config;
+
+    // Apply the new envelopes to the last reported telemetry
+    updateTelemetry(dshot_limiter_stats.current, dshot_limiter_stats.temperature);
+}
+
+// Takes the latest ESC telemetry and updates the throttle scale of the limiter
+void DShotRMT::updateTelemetry(uint16_t current, uint8_t temperature)
+{
+    dshot_limiter_stats.current = current;
+    dshot_limiter_stats.temperature = temperature;
+
+    const uint16_t current_scale = calculateLimiterScale(current, dshot_limiter_config.current_soft_limit, dshot_limiter_config.current_hard_limit);
+    const uint16_t temperature_scale = calculateLimiterScale(temperature, dshot_limiter_config.temperature_soft_limit, dshot_limiter_config.temperature_hard_limit);
+
+    // The stricter envelope wins
+    dshot_limiter_stats.throttle_scale = min(current_scale, temperature_scale);
+}
+
+// Returns the statistics of the telemetry limiter
+const dshot_limiter_stats_t &DShotRMT::getLimiterStats() const
+{
+    return dshot_limiter_stats;
+}
+
+// Sends one of the official DShot commands
+void DShotRMT::sendCommand(dshot_cmd_t dshot_command)
+{
+    // The ESC only accepts commands with the telemetric bit set.
+    sendDShotValue(dshot_command, ENABLE_TELEMETRIC);
+}
+
+// Builds a DShot packet for a raw value and sends it over the RMT interface
+void DShotRMT::sendDShotValue(uint16_t value, telemetric_request_t telemetric_request)
+{
+    dshot_packet_t dshot_rmt_packet = {};
+
+    dshot_rmt_packet.throttle_value = value;
+    dshot_rmt_packet.telemetric_request = telemetric_request;
 
     // Calculate the checksum for the DShot packet using the calculateCRC function.
     dshot_rmt_packet.checksum = calculateCRC(dshot_rmt_packet);
@@ -159,26 +326,260 @@ void DShotRMT::sendThrottleValue(uint16_t throttle_value)
     sendRmtPaket(dshot_rmt_packet);
 }
 
+// Returns the active DShot mode
+dshot_mode_t DShotRMT::getMode() const
+{
+    return dshot_config.mode;
+}
+
+// Returns whether the active DShot mode runs bidirectional
+bool DShotRMT::isBidirectional() const
+{
+    return dshot_config.is_bidirectional;
+}
+
+// Waits for the end of the last frame
+bool DShotRMT::waitTxDone(TickType_t wait_time)
+{
+    // Nothing is sent without an installed channel
+    if (!is_installed)
+    {
+        return true;
+    }
+
+    return (rmt_wait_tx_done(dshot_tx_rmt_config.channel, wait_time) == ESP_OK);
+}
+
+// Corrects a tick value by the averaged error measured on the pin and reports the error in nanoseconds
+static void applyTimingCorrection(uint16_t &ticks, uint32_t measured_sum, uint16_t measured_count, uint8_t clk_div, int16_t &error_ns)
+{
+    // Nothing measured, keep the nominal value
+    if (measured_count == 0)
+    {
+        return;
+    }
+
+    // Average error in APB cycles, the RX channel counts in units of DSHOT_CALIBRATION_CLK_DIVIDER cycles
+    const int32_t nominal = static_cast<int32_t>(ticks) * clk_div;
+    const int32_t measured = static_cast<int32_t>(measured_sum / measured_count) * DSHOT_CALIBRATION_CLK_DIVIDER;
+    const int32_t error = measured - nominal;
+
+    error_ns = static_cast<int16_t>((error * 1000) / static_cast<int32_t>(APB_CLK_FREQ / 1000000));
+
+    // Round the error to full RMT ticks and never go below a single tick
+    const int32_t correction = (error >= 0) ? ((error + clk_div / 2) / clk_div) : ((error - clk_div / 2) / clk_div);
+    const int32_t corrected_ticks = static_cast<int32_t>(ticks) - correction;
+
+    ticks = (corrected_ticks < 1) ? 1 : static_cast<uint16_t>(corrected_ticks);
+}
+
+// Loops the DShot output into a RMT RX channel and corrects the bit timing by the measured durations
+bool DShotRMT::calibrateTiming(rmt_channel_t rx_channel, gpio_num_t rx_gpio)
+{
+    dshot_timing_calibration = {};
+
+    // Nothing to calibrate without an active DShot mode
+    if (!is_installed || dshot_config.ticks_per_bit == 0)
+    {
+        return false;
+    }
+
+    // The RX channel must be free, configuring it would take it away from its owner
+    rmt_channel_status_result_t channel_status = {};
+
+    if ((rx_channel < 0) || (rx_channel >= RMT_CHANNEL_MAX) || (rx_channel == dshot_config.rmt_channel) ||
+        (rmt_get_channel_status(&channel_status) != ESP_OK) || (channel_status.status[rx_channel] != RMT_CHANNEL_UNINIT))
+    {
+        return false;
+    }
+
+    // Without a separate pin the TX pin is read back via the GPIO matrix
+    const bool is_loopback = (rx_gpio == GPIO_NUM_NC);
+
+    // Set up RMT configuration for reading back the DShot frames
+    rmt_config_t dshot_rx_rmt_config = {};
+    dshot_rx_rmt_config.rmt_mode = RMT_MODE_RX;
+    dshot_rx_rmt_config.channel = rx_channel;
+    dshot_rx_rmt_config.gpio_num = is_loopback ? dshot_config.gpio_num : rx_gpio;
+    dshot_rx_rmt_config.mem_block_num = DSHOT_MEM_BLOCK_NUM;
+    dshot_rx_rmt_config.clk_div = DSHOT_CALIBRATION_CLK_DIVIDER;
+    dshot_rx_rmt_config.rx_config.filter_en = false;
+
+    // Any level longer than two bits ends the frame
+    dshot_rx_rmt_config.rx_config.idle_threshold = (dshot_config.ticks_per_bit * dshot_config.clk_div * 2) / DSHOT_CALIBRATION_CLK_DIVIDER;
+
+    if (rmt_config(&dshot_rx_rmt_config) != ESP_OK)
+    {
+        return false;
+    }
+
+    // Route the TX signal back to the output and keep the pin readable
+    if (is_loopback)
+    {
+        rmt_set_gpio(dshot_config.rmt_channel, RMT_MODE_TX, dshot_config.gpio_num, false);
+        gpio_set_direction(dshot_config.gpio_num, GPIO_MODE_INPUT_OUTPUT);
+    }
+
+    RingbufHandle_t rx_ringbuf = nullptr;
+    bool is_rx_installed = (rmt_driver_install(rx_channel, DSHOT_CALIBRATION_RX_BUFFER, 0) == ESP_OK);
+
+    if (is_rx_installed)
+    {
+        rmt_get_ringbuf_handle(rx_channel, &rx_ringbuf);
+    }
+
+    uint32_t zero_high_sum = 0, zero_low_sum = 0, one_high_sum = 0, one_low_sum = 0;
+    uint16_t zero_high_count = 0, zero_low_count = 0, one_high_count = 0, one_low_count = 0;
+
+    for (int frame = 0; (rx_ringbuf != nullptr) && (frame < DSHOT_CALIBRATION_FRAMES); frame++)
+    {
+        rmt_rx_start(rx_channel, true);
+
+        // The calibration packet has an invalid CRC, so connected ESCs will ignore it
+        buildTxRmtItem(DSHOT_CALIBRATION_PACKET);
+        rmt_write_items(dshot_config.rmt_channel, dshot_tx_rmt_item, DSHOT_PACKET_LENGTH, true);
+
+        size_t rx_size = 0;
+        rmt_item32_t *rx_items = static_cast<rmt_item32_t *>(xRingbufferReceive(rx_ringbuf, &rx_size, pdMS_TO_TICKS(DSHOT_CALIBRATION_TIMEOUT_MS)));
+
+        rmt_rx_stop(rx_channel);
+
+        if (rx_items == nullptr)
+        {
+            continue;
+        }
+
+        // Every received item holds the leading and the trailing level of one bit
+        if ((rx_size / sizeof(rmt_item32_t)) >= DSHOT_PAUSE_BIT)
+        {
+            uint16_t packet = DSHOT_CALIBRATION_PACKET;
+
+            // The active pulse has the level opposite to the idle level, low for bidirectional DShot
+            const uint32_t active_level = dshot_config.is_bidirectional ? 0 : 1;
+
+            for (int i = 0; i < DSHOT_PAUSE_BIT; i++, packet <<= 1)
+            {
+                const uint16_t active = (rx_items[i].level0 == active_level) ? rx_items[i].duration0 : rx_items[i].duration1;
+                const uint16_t passive = (rx_items[i].level0 == active_level) ? rx_items[i].duration1 : rx_items[i].duration0;
+
+                // The passive pulse of the last bit merges into the idle level
+                const bool is_passive_valid = (i != DSHOT_PAUSE_BIT - 1);
+
+                if (packet & 0b1000000000000000)
+                {
+                    one_high_sum += active;
+                    one_high_count++;
+                    one_low_sum += is_passive_valid ? passive : 0;
+                    one_low_count += is_passive_valid ? 1 : 0;
+                }
+                else
+                {
+                    zero_high_sum += active;
+                    zero_high_count++;
+                    zero_low_sum += is_passive_valid ? passive : 0;
+                    zero_low_count += is_passive_valid ? 1 : 0;
+                }
+            }
+
+            dshot_timing_calibration.frames_measured++;
+        }
+
+        vRingbufferReturnItem(rx_ringbuf, rx_items);
+    }
+
+    // Release the RX channel and restore the TX channel
+    if (is_rx_installed)
+    {
+        rmt_driver_uninstall(rx_channel);
+    }
+
+    if (is_loopback)
+    {
+        rmt_set_gpio(dshot_config.rmt_channel, RMT_MODE_TX, dshot_config.gpio_num, false);
+    }
+
+    // Keep the nominal timing if nothing came back
+    if (dshot_timing_calibration.frames_measured == 0)
+    {
+        return false;
+    }
+
+    applyTimingCorrection(dshot_config.ticks_zero_high, zero_high_sum, zero_high_count, dshot_config.clk_div, dshot_timing_calibration.zero_high_error_ns);
+    applyTimingCorrection(dshot_config.ticks_zero_low, zero_low_sum, zero_low_count, dshot_config.clk_div, dshot_timing_calibration.zero_low_error_ns);
+    applyTimingCorrection(dshot_config.ticks_one_high, one_high_sum, one_high_count, dshot_config.clk_div, dshot_timing_calibration.one_high_error_ns);
+    applyTimingCorrection(dshot_config.ticks_one_low, one_low_sum, one_low_count, dshot_config.clk_div, dshot_timing_calibration.one_low_error_ns);
+
+    dshot_timing_calibration.is_valid = true;
+
+    return true;
+}
+
+// Returns the measured timing accuracy of the last calibration run
+const dshot_timing_calibration_t &DShotRMT::getTimingCalibration() const
+{
+    return dshot_timing_calibration;
+}
+
+// Sets or clears the throttle remapping table, entries are checked once here instead of per frame
+bool DShotRMT::setThrottleMap(const uint16_t *throttle_map)
+{
+    // An entry below the minimum throttle would be sent as a DShot command
+    for (int i = 0; (throttle_map != nullptr) && (i < DSHOT_THROTTLE_RANGE); i++)
+    {
+        if ((throttle_map[i] < DSHOT_THROTTLE_MIN) || (throttle_map[i] > DSHOT_THROTTLE_MAX))
+        {
+            return false;
+        }
+    }
+
+    this->throttle_map = throttle_map;
+
+    return true;
+}
+
+// Fills a throttle map inverting thrust = (1 - expo) * throttle + expo * throttle^2
+void DShotRMT::buildThrustLinearizationMap(uint16_t *throttle_map, float thrust_expo)
+{
+    // Keep the model within linear and purely quadratic
+    thrust_expo = constrain(thrust_expo, 0.0f, 1.0f);
+
+    for (int i = 0; i < DSHOT_THROTTLE_RANGE; i++)
+    {
+        // Requested thrust normalized to 0.0 ... 1.0
+        const float thrust = static_cast<float>(i) / (DSHOT_THROTTLE_RANGE - 1);
+        float throttle = thrust;
+
+        // Solve thrust_expo * throttle^2 + (1 - thrust_expo) * throttle - thrust = 0
+        if (thrust_expo > 0.0f)
+        {
+            const float linear = 1.0f - thrust_expo;
+            throttle = (sqrtf(linear * linear + 4.0f * thrust_expo * thrust) - linear) / (2.0f * thrust_expo);
+        }
+
+        throttle_map[i] = static_cast<uint16_t>(DSHOT_THROTTLE_MIN + lroundf(throttle * (DSHOT_THROTTLE_RANGE - 1)));
+    }
+}
+
 // This method builds the RMT data transmission sequence for the DShot protocol
 rmt_item32_t *DShotRMT::buildTxRmtItem(uint16_t parsed_packet)
 {
     // Check if DShot is set to bidirectional mode
     if (dshot_config.is_bidirectional)
     {
-        // If bidirectional, invert the high/low bits
+        // If bidirectional, invert the levels, the bit timing stays the same
         for (int i = 0; i < DSHOT_PAUSE_BIT; i++, parsed_packet <<= 1)
         {
             if (parsed_packet & 0b1000000000000000)
             {
                 // Set RMT item for a logic high signal
-                dshot_tx_rmt_item[i].duration0 = dshot_config.ticks_one_low;
-                dshot_tx_rmt_item[i].duration1 = dshot_config.ticks_one_high;
+                dshot_tx_rmt_item[i].duration0 = dshot_config.ticks_one_high;
+                dshot_tx_rmt_item[i].duration1 = dshot_config.ticks_one_low;
             }
             else
             {
                 // Set RMT item for a logic low signal
-                dshot_tx_rmt_item[i].duration0 = dshot_config.ticks_zero_low;
-                dshot_tx_rmt_item[i].duration1 = dshot_config.ticks_zero_high;
+                dshot_tx_rmt_item[i].duration0 = dshot_config.ticks_zero_high;
+                dshot_tx_rmt_item[i].duration1 = dshot_config.ticks_zero_low;
             }
 
             // Set level of RMT item
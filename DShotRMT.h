@@ -18,8 +18,18 @@ constexpr auto DSHOT_LIB_VERSION = "0.2.4";
 // Constants related to the DShot protocol
 constexpr auto DSHOT_CLK_DIVIDER = 8;    // Slow down RMT clock to 0.1 microseconds / 100 nanoseconds per cycle
 constexpr auto DSHOT_PACKET_LENGTH = 17; // Last pack is the pause
+constexpr auto DSHOT_MEM_BLOCK_NUM = 1;  // A single RMT memory block holds a full frame, leaves the others to further motors
 constexpr auto DSHOT_THROTTLE_MIN = 48;
 constexpr auto DSHOT_THROTTLE_MAX = 2047;
+constexpr auto DSHOT_THROTTLE_RANGE = (DSHOT_THROTTLE_MAX - DSHOT_THROTTLE_MIN + 1); // Entries of a throttle map
+constexpr auto DSHOT_3D_THROTTLE_REVERSE_MIN = 48;   // Slowest reverse speed
+constexpr auto DSHOT_3D_THROTTLE_REVERSE_MAX = 1047; // Full reverse speed
+constexpr auto DSHOT_3D_THROTTLE_FORWARD_MIN = 1049; // Slowest forward speed
+constexpr auto DSHOT_3D_THROTTLE_FORWARD_MAX = 2047; // Full forward speed
+constexpr auto DSHOT_3D_THROTTLE_SIGNED_MAX = 999;   // Signed 3D throttle range is -999 ... 999
+constexpr auto DSHOT_3D_DEADBAND_DEFAULT = 0;
+constexpr auto DSHOT_3D_REVERSAL_ERPM_DEFAULT = 1500;  // eRPM up to which a change of direction is sent right away
+constexpr auto DSHOT_LIMITER_SCALE_FULL = 256; // Throttle scale of the limiter, 256 = not limiting
 constexpr auto DSHOT_NULL_PACKET = 0b0000000000000000;
 constexpr auto DSHOT_PAUSE = 21; // 21-bit is recommended
 constexpr auto DSHOT_PAUSE_BIT = 16;
@@ -27,6 +37,18 @@ constexpr auto F_CPU_RMT = APB_CLK_FREQ;
 constexpr auto RMT_CYCLES_PER_SEC = (F_CPU_RMT / DSHOT_CLK_DIVIDER);
 constexpr auto RMT_CYCLES_PER_ESP_CYCLE = (F_CPU / RMT_CYCLES_PER_SEC);
 
+// Constants related to the loopback timing calibration
+constexpr auto DSHOT_CALIBRATION_PACKET = 0b1010011001011010; // Equal number of "0" and "1" bits, invalid CRC on purpose
+constexpr auto DSHOT_CALIBRATION_FRAMES = 8;                  // Number of frames averaged per calibration run
+constexpr auto DSHOT_CALIBRATION_CLK_DIVIDER = 1;             // RX samples with full APB resolution (12.5 nanoseconds per cycle)
+constexpr auto DSHOT_CALIBRATION_RX_BUFFER = 1024;            // Size of the RX ringbuffer in bytes
+constexpr auto DSHOT_CALIBRATION_TIMEOUT_MS = 10;
+
+// Constants related to the eRPM prediction
+constexpr auto DSHOT_ERPM_PREDICTION_HORIZON_US = 2000; // Predictions are held beyond this time after the last sample
+constexpr auto DSHOT_ERPM_SLOPE_FRACTION_BITS = 16;     // Fixed-point fraction of the eRPM slope per microsecond
+constexpr auto DSHOT_ERPM_SLOPE_FILTER_SHIFT = 2;       // Slope low pass, each new slope counts 1/4
+
 // Enumeration for the DShot mode
 typedef enum dshot_mode_e
 {
@@ -38,7 +60,7 @@ typedef enum dshot_mode_e
 } dshot_mode_t;
 
 // Array of human-readable DShot mode names
-static const char *const dshot_mode_name[] = {
+static constexpr const char *const dshot_mode_name[] = {
     "DSHOT_OFF",
     "DSHOT150",
     "DSHOT300",
@@ -82,7 +104,7 @@ typedef enum dshot_erpm_exit_mode_e
 typedef struct dshot_config_s
 {
     dshot_mode_t mode;
-    String name_str;
+    const char *name_str;
     bool is_bidirectional;
     gpio_num_t gpio_num;
     uint8_t pin_num;
@@ -96,6 +118,38 @@ typedef struct dshot_config_s
     uint16_t ticks_one_low;
 } dshot_config_t;
 
+// Result of the loopback timing calibration, errors are measured minus nominal.
+// High is the active pulse of a bit, which is low on the pin for bidirectional DShot.
+typedef struct dshot_timing_calibration_s
+{
+    bool is_valid;
+    uint16_t frames_measured;
+    int16_t zero_high_error_ns;
+    int16_t zero_low_error_ns;
+    int16_t one_high_error_ns;
+    int16_t one_low_error_ns;
+} dshot_timing_calibration_t;
+
+// Envelopes of the telemetry limiter, a hard limit of 0 disables the envelope.
+// Between the soft and the hard limit the throttle is scaled down linearly,
+// at the hard limit only the minimum throttle remains.
+typedef struct dshot_limiter_config_s
+{
+    uint16_t current_soft_limit;    // in 0.01 A
+    uint16_t current_hard_limit;    // in 0.01 A
+    uint8_t temperature_soft_limit; // in °C
+    uint8_t temperature_hard_limit; // in °C
+} dshot_limiter_config_t;
+
+// Statistics of the telemetry limiter
+typedef struct dshot_limiter_stats_s
+{
+    uint32_t frames_limited; // Frames sent with a reduced throttle
+    uint16_t throttle_scale; // Active scale, DSHOT_LIMITER_SCALE_FULL when not limiting
+    uint16_t current;        // Last reported current in 0.01 A
+    uint8_t temperature;     // Last reported temperature in °C
+} dshot_limiter_stats_t;
+
 // The official DShot Commands
 typedef enum dshot_cmd_e
 {
@@ -159,43 +213,251 @@ static const unsigned char GCR_decode[32] =
         0xFF, 4, 12, 0xFF, // 28 - 31
 };
 
+// State of the eRPM prediction for a single motor
+typedef struct dshot_erpm_prediction_s
+{
+    uint32_t sample_time_us; // Timestamp of the last eRPM sample
+    int32_t erpm;            // Last eRPM sample
+    int32_t erpm_slope;      // eRPM change per microsecond, fixed-point
+    uint8_t sample_count;    // Samples since reset, a slope needs two
+} dshot_erpm_prediction_t;
+
 // The main DShotRMT class
 class DShotRMT
 {
 public:
-    // Constructor for the DShotRMT class
-    DShotRMT(gpio_num_t gpio, rmt_channel_t rmtChannel);
-    DShotRMT(uint8_t pin, uint8_t channel);
-    DShotRMT(uint8_t pin);
+    // Constructor for the DShotRMT class, all hardware setup is deferred to begin(),
+    // so global instances are constant-initialized without any code running at boot.
+    constexpr DShotRMT(gpio_num_t gpio, rmt_channel_t rmtChannel)
+        : dshot_tx_rmt_item{},
+          dshot_tx_rmt_config{},
+          dshot_config{DSHOT_OFF, dshot_mode_name[DSHOT_OFF], false, gpio, static_cast<uint8_t>(gpio), rmtChannel,
+                       DSHOT_MEM_BLOCK_NUM, 0, DSHOT_CLK_DIVIDER, 0, 0, 0, 0},
+          dshot_timing_calibration{},
+          throttle_map(nullptr),
+          deadband_3d(DSHOT_3D_DEADBAND_DEFAULT),
+          rotation_direction(0),
+          reversal_erpm(DSHOT_3D_REVERSAL_ERPM_DEFAULT),
+          dshot_limiter_config{},
+          dshot_limiter_stats{0, DSHOT_LIMITER_SCALE_FULL, 0, 0},
+          is_installed(false) {}
+
+    constexpr DShotRMT(uint8_t pin, uint8_t channel)
+        : DShotRMT(static_cast<gpio_num_t>(pin), static_cast<rmt_channel_t>(channel)) {}
+
+    // ...simplest but only for testing
+    constexpr DShotRMT(uint8_t pin)
+        : DShotRMT(static_cast<gpio_num_t>(pin), static_cast<rmt_channel_t>(RMT_CHANNEL_MAX - 1)) {}
 
     // Destructor for the DShotRMT class
     ~DShotRMT();
 
-    // Copy constructor for the DShotRMT class
+    // Copy constructor for the DShotRMT class, copies the settings only.
+    // The copy needs its own begin() on a free RMT channel.
     DShotRMT(DShotRMT const &);
 
+    // Assigning would hand over an installed channel twice, so it is not supported.
+    DShotRMT &operator=(DShotRMT const &) = delete;
+
     // The begin() function initializes the DShotRMT class with
     // a given DShot mode (DSHOT_OFF, DSHOT150, DSHOT300, DSHOT600, DSHOT1200)
     // and a bidirectional flag. It returns a boolean value
     // indicating whether or not the initialization was successful.
+    // Calling begin() again reinstalls the channel, e.g. to change the mode.
     bool begin(dshot_mode_t dshot_mode = DSHOT_OFF, bool is_bidirectional = false);
 
+    // The beginGroup() function sets up all motors of a group with the same mode
+    // and installs all RMT channels in one pass. It returns true when every
+    // channel was installed successfully.
+    static bool beginGroup(DShotRMT *const motors[], uint8_t motor_count, dshot_mode_t dshot_mode = DSHOT_OFF, bool is_bidirectional = false);
+
+    // The end() function stops the output and uninstalls the RMT driver of the
+    // channel. begin() starts it again.
+    void end();
+
     // The sendThrottleValue() function sends a DShot packet with a given
     // throttle value (between 49 and 2047) and an optional telemetry
     // request flag.
     // void sendThrottleValue(uint16_t throttle_value, telemetric_request_t telemetric_request = NO_TELEMETRIC);
     void sendThrottleValue(uint16_t throttle_value);
 
+    // The sendThrottle3D() function sends a signed throttle value (between -999
+    // and 999) to an ESC running in 3D mode (see DSHOT_CMD_3D_MODE_ON). Values
+    // within the deadband stop the motor, the remaining range is scaled onto the
+    // full reverse (48 - 1047) or forward (1049 - 2047) range. A change of direction
+    // is sent right away without neutral frames, braking is left to the ESC.
+    void sendThrottle3D(int16_t throttle_value);
+
+    // The sendThrottle3D() function with the eRPM of the motor, e.g. from
+    // DShotErpmPredictor::predict(), holds a change of direction: neutral is sent,
+    // so the ESC brakes (or coasts without brake on stop), until the eRPM has
+    // dropped to the reversal threshold. Then the new direction is sent, so the
+    // ESC never drives hard against the rotation and desyncs.
+    void sendThrottle3D(int16_t throttle_value, uint32_t erpm);
+
+    // Sets the neutral deadband of the signed 3D throttle (between 0 and 997).
+    void set3DDeadband(uint16_t deadband);
+
+    // Sets the eRPM up to which a change of direction is sent right away.
+    void setReversalThreshold(uint32_t erpm);
+
+    // The sendCommand() function sends one of the official DShot commands. Most
+    // settings commands need to be sent 6x before they are applied by the ESC.
+    void sendCommand(dshot_cmd_t dshot_command);
+
+    // Returns the active DShot mode and whether it runs bidirectional.
+    dshot_mode_t getMode() const;
+    bool isBidirectional() const;
+
+    // The waitTxDone() function waits until the last frame has left the RMT
+    // channel, at most wait_time ticks. It returns true if the channel is idle.
+    bool waitTxDone(TickType_t wait_time = portMAX_DELAY);
+
+    // The calibrateTiming() function loops the DShot output into a RMT RX channel,
+    // measures the real active and passive pulse of every bit and corrects the
+    // tick values of the active mode. Without a rx_gpio the TX pin is read back
+    // internally via the GPIO matrix, otherwise a jumper to rx_gpio is expected.
+    // Must be called after begin(), results are lost when begin() is called again.
+    // rx_channel must not be installed, e.g. by another motor, or false is returned
+    // without touching it.
+    bool calibrateTiming(rmt_channel_t rx_channel, gpio_num_t rx_gpio = GPIO_NUM_NC);
+
+    // Returns the measured timing accuracy of the last calibration run.
+    const dshot_timing_calibration_t &getTimingCalibration() const;
+
+    // The setThrottleMap() function remaps every throttle value sent by sendThrottleValue()
+    // through a table of DSHOT_THROTTLE_RANGE entries (index = throttle - DSHOT_THROTTLE_MIN),
+    // e.g. for thrust linearization. sendThrottle3D() is not remapped, the table only covers
+    // the unidirectional range. The table is not copied, so several motors can share it, and
+    // must not be changed while in use. A table with an entry outside DSHOT_THROTTLE_MIN and
+    // DSHOT_THROTTLE_MAX is rejected and the previous one is kept, nullptr disables remapping.
+    bool setThrottleMap(const uint16_t *throttle_map);
+
+    // The buildThrustLinearizationMap() function fills a throttle map for motors
+    // with thrust = (1 - thrust_expo) * throttle + thrust_expo * throttle^2,
+    // thrust_expo between 0.0 (linear) and 1.0 (purely quadratic).
+    static void buildThrustLinearizationMap(uint16_t *throttle_map, float thrust_expo);
+
+    // The setLimiter() function sets the current and temperature envelopes of
+    // the telemetry limiter. The limiter scales down every throttle value sent by
+    // sendThrottleValue() and sendThrottle3D() while an envelope is exceeded.
+    void setLimiter(const dshot_limiter_config_t &limiter_config);
+
+    // The updateTelemetry() function passes the latest ESC telemetry (EDT or UART)
+    // to the limiter. The throttle scale is calculated here, not per frame.
+    void updateTelemetry(uint16_t current, uint8_t temperature);
+
+    // Returns the statistics of the telemetry limiter.
+    const dshot_limiter_stats_t &getLimiterStats() const;
+
 private:
     rmt_item32_t dshot_tx_rmt_item[DSHOT_PACKET_LENGTH]; // An array of RMT items used to send a DShot packet.
     rmt_config_t dshot_tx_rmt_config;                    // The RMT configuration used for sending DShot packets.
     dshot_config_t dshot_config;                         // The configuration for the DShot mode.
+    dshot_timing_calibration_t dshot_timing_calibration; // The measured accuracy of the bit timing.
+    const uint16_t *throttle_map;                        // Optional throttle remapping table, not owned.
+    uint16_t deadband_3d;                                // Neutral deadband of the signed 3D throttle.
+    int8_t rotation_direction;                           // Direction of the last 3D throttle frame, 0 before the first one.
+    uint32_t reversal_erpm;                              // eRPM up to which a change of direction is sent right away.
+    dshot_limiter_config_t dshot_limiter_config;         // The envelopes of the telemetry limiter.
+    dshot_limiter_stats_t dshot_limiter_stats;           // The statistics of the telemetry limiter.
+    bool is_installed;                                   // Whether the RMT driver of the channel is installed.
+
+    void setupConfig(dshot_mode_t dshot_mode, bool is_bidirectional); // Sets up the DShot mode and the RMT channel.
+    bool installDriver();                                             // Installs the RMT driver of the channel.
 
     rmt_item32_t *buildTxRmtItem(uint16_t parsed_packet);       // Constructs an RMT item from a parsed DShot packet.
     uint16_t calculateCRC(const dshot_packet_t &dshot_packet);  // Calculates the CRC checksum for a DShot packet.
     uint16_t parseRmtPaket(const dshot_packet_t &dshot_packet); // Parses an RMT packet to obtain a DShot packet.
 
-    void sendRmtPaket(const dshot_packet_t &dshot_packet); // Sends a DShot packet via RMT.
+    void sendDShotValue(uint16_t value, telemetric_request_t telemetric_request); // Builds and sends a DShot packet for a raw value.
+    void sendRmtPaket(const dshot_packet_t &dshot_packet);                        // Sends a DShot packet via RMT.
+};
+
+// Predicts the eRPM of MOTOR_COUNT motors between telemetry samples using a
+// constant acceleration model. The state of all motors is stored in one array,
+// update() and predict() are O(1) and use fixed-point math only.
+template <uint8_t MOTOR_COUNT>
+class DShotErpmPredictor
+{
+public:
+    constexpr DShotErpmPredictor()
+        : prediction{},
+          horizon_us(DSHOT_ERPM_PREDICTION_HORIZON_US) {}
+
+    // Adds a timestamped eRPM sample of a motor, e.g. from the ESC telemetry.
+    // Samples not newer than the last one are dropped.
+    void update(uint8_t motor, uint32_t erpm, uint32_t sample_time_us)
+    {
+        dshot_erpm_prediction_t &state = prediction[motor];
+        const int32_t sample_gap_us = static_cast<int32_t>(sample_time_us - state.sample_time_us);
+
+        // Duplicate or out of order samples must not reset the slope
+        if ((state.sample_count > 0) && (sample_gap_us <= 0))
+        {
+            return;
+        }
+
+        // Only samples close enough to each other give a usable slope
+        if ((state.sample_count > 0) && (static_cast<uint32_t>(sample_gap_us) <= horizon_us))
+        {
+            int64_t slope = (static_cast<int64_t>(static_cast<int32_t>(erpm) - state.erpm) << DSHOT_ERPM_SLOPE_FRACTION_BITS) / sample_gap_us;
+            slope = constrain(slope, static_cast<int64_t>(INT32_MIN), static_cast<int64_t>(INT32_MAX));
+
+            // Smooth the slope, the first one is taken as is
+            if (state.sample_count > 1)
+            {
+                state.erpm_slope += (static_cast<int32_t>(slope) - state.erpm_slope) >> DSHOT_ERPM_SLOPE_FILTER_SHIFT;
+            }
+            else
+            {
+                state.erpm_slope = static_cast<int32_t>(slope);
+            }
+
+            state.sample_count = (state.sample_count < 2) ? (state.sample_count + 1) : 2;
+        }
+        else
+        {
+            state.erpm_slope = 0;
+            state.sample_count = 1;
+        }
+
+        state.erpm = static_cast<int32_t>(erpm);
+        state.sample_time_us = sample_time_us;
+    }
+
+    // Returns the estimated eRPM of a motor at any query time, extrapolation
+    // stops at the horizon after the last sample.
+    uint32_t predict(uint8_t motor, uint32_t query_time_us) const
+    {
+        const dshot_erpm_prediction_t &state = prediction[motor];
+
+        // Queries before the last sample get the sample itself
+        int32_t elapsed_us = static_cast<int32_t>(query_time_us - state.sample_time_us);
+        elapsed_us = constrain(elapsed_us, static_cast<int32_t>(0), static_cast<int32_t>(horizon_us));
+
+        // Round the fixed-point change to full eRPM
+        const int64_t erpm_change = static_cast<int64_t>(state.erpm_slope) * elapsed_us + (1 << (DSHOT_ERPM_SLOPE_FRACTION_BITS - 1));
+        const int64_t erpm = state.erpm + (erpm_change >> DSHOT_ERPM_SLOPE_FRACTION_BITS);
+
+        return (erpm > 0) ? static_cast<uint32_t>(erpm) : 0;
+    }
+
+    // Sets how far beyond the last sample the eRPM is extrapolated.
+    void setHorizon(uint32_t horizon_us)
+    {
+        this->horizon_us = min(horizon_us, static_cast<uint32_t>(INT32_MAX));
+    }
+
+    // Forgets all samples of a motor, e.g. after a telemetry dropout.
+    void reset(uint8_t motor)
+    {
+        prediction[motor] = {};
+    }
+
+private:
+    dshot_erpm_prediction_t prediction[MOTOR_COUNT]; // Prediction state of all motors, contiguous.
+    uint32_t horizon_us;                             // Maximum extrapolation time after the last sample.
 };
 
 #endif
@@ -0,0 +1,169 @@
+/*
+ * Title: dshot_benchmark.ino
+ * Author: derdoktor667
+ * Date: 2026-10-18
+ *
+ * Description: Measures the cost of the DShot output for 1 up to all RMT TX
+ * channels, every DShot mode, with and without bidirectional DShot. Prints
+ * a table of CPU cycles per send on an idle channel, achievable frame rate
+ * per motor, RMT TX end interrupts per frame and driver memory use to the
+ * USB serial port. The CPU time spent in the interrupts is not measured.
+ *
+ * Motors only get the minimum throttle, but remove the propellers anyway.
+ */
+
+#include <Arduino.h>
+#include <soc/soc_caps.h>
+#include "DShotRMT.h"
+
+// USB serial port needed for this example
+const auto USB_SERIAL_BAUD = 115200;
+#define USB_Serial Serial
+
+// Number of RMT channels able to send DShot on this chip
+#ifdef SOC_RMT_TX_CANDIDATES_PER_GROUP
+const auto MOTOR_COUNT_MAX = SOC_RMT_TX_CANDIDATES_PER_GROUP;
+#else
+const auto MOTOR_COUNT_MAX = RMT_CHANNEL_MAX;
+#endif
+
+// Workloads of the benchmark
+const uint8_t MOTOR_COUNTS[] = {1, 2, 4, 8, 16};
+const dshot_mode_t DSHOT_MODES[] = {DSHOT150, DSHOT300, DSHOT600, DSHOT1200};
+const bool BIDIRECTIONAL_MODES[] = {false, true};
+const auto FRAMES_PER_MOTOR = 1000;
+
+// Initialize a DShotRMT object for every possible motor (pin, channel),
+// chips with less TX channels only use the first ones
+DShotRMT motors[] = {
+    DShotRMT(4, 0),
+    DShotRMT(5, 1),
+    DShotRMT(13, 2),
+    DShotRMT(14, 3),
+    DShotRMT(18, 4),
+    DShotRMT(19, 5),
+    DShotRMT(21, 6),
+    DShotRMT(22, 7)};
+
+DShotRMT *const motor_group[] = {&motors[0], &motors[1], &motors[2], &motors[3], &motors[4], &motors[5], &motors[6], &motors[7]};
+
+// Number of motors used on this chip
+const uint8_t MOTOR_COUNT_AVAILABLE = (MOTOR_COUNT_MAX < (sizeof(motors) / sizeof(motors[0]))) ? MOTOR_COUNT_MAX : (sizeof(motors) / sizeof(motors[0]));
+
+// Counted by the RMT driver interrupt at the end of every frame
+volatile uint32_t tx_end_interrupts = 0;
+
+void IRAM_ATTR onTxEnd(rmt_channel_t, void *)
+{
+    tx_end_interrupts = tx_end_interrupts + 1;
+}
+
+void setup()
+{
+    USB_Serial.begin(USB_SERIAL_BAUD);
+
+    rmt_register_tx_end_callback(onTxEnd, nullptr);
+
+    USB_Serial.printf("DShotRMT %s benchmark, %d TX channels, %u bytes per motor object\n", DSHOT_LIB_VERSION, MOTOR_COUNT_AVAILABLE, static_cast<unsigned>(sizeof(DShotRMT)));
+    USB_Serial.println("motors | mode      | bidir | cycles/send | frames/s/motor | irq/frame | driver heap");
+
+    for (auto motor_count : MOTOR_COUNTS)
+    {
+        // Workloads with more motors than RMT TX channels can not run on this chip, 16 motors on none
+        if (motor_count > MOTOR_COUNT_AVAILABLE)
+        {
+            USB_Serial.printf("%6d | not measured, more motors than the %d RMT TX channels of this chip\n", motor_count, MOTOR_COUNT_AVAILABLE);
+            continue;
+        }
+
+        for (auto dshot_mode : DSHOT_MODES)
+        {
+            for (auto is_bidirectional : BIDIRECTIONAL_MODES)
+            {
+                runBenchmark(motor_count, dshot_mode, is_bidirectional);
+            }
+        }
+    }
+
+    // Arm all ESCs again, the last workload may have used fewer motors
+    DShotRMT::beginGroup(motor_group, MOTOR_COUNT_AVAILABLE, DSHOT300);
+}
+
+void loop()
+{
+    // Keep the ESCs armed at minimum throttle
+    for (uint8_t i = 0; i < MOTOR_COUNT_AVAILABLE; i++)
+    {
+        motors[i].sendThrottleValue(DSHOT_THROTTLE_MIN);
+    }
+}
+
+// Sends FRAMES_PER_MOTOR frames to each motor of a group and prints one table row
+void runBenchmark(uint8_t motor_count, dshot_mode_t dshot_mode, bool is_bidirectional)
+{
+    // Start without any installed channel, so only the driver of this group is measured
+    for (uint8_t i = 0; i < MOTOR_COUNT_AVAILABLE; i++)
+    {
+        motors[i].end();
+    }
+
+    const auto heap_before = ESP.getFreeHeap();
+    const auto is_success = DShotRMT::beginGroup(motor_group, motor_count, dshot_mode, is_bidirectional);
+    const auto heap_used = static_cast<int32_t>(heap_before) - static_cast<int32_t>(ESP.getFreeHeap());
+
+    if (!is_success)
+    {
+        USB_Serial.printf("%6d | %-9s | %5d | begin failed\n", motor_count, dshot_mode_name[dshot_mode], is_bidirectional);
+        return;
+    }
+
+    // CPU cost of a send, the channel is idle before each one
+    uint64_t send_cycles = 0;
+
+    for (int frame = 0; frame < FRAMES_PER_MOTOR; frame++)
+    {
+        for (uint8_t i = 0; i < motor_count; i++)
+        {
+            motors[i].waitTxDone();
+
+            const uint32_t start_cycles = ESP.getCycleCount();
+            motors[i].sendThrottleValue(DSHOT_THROTTLE_MIN);
+            send_cycles += ESP.getCycleCount() - start_cycles;
+        }
+    }
+
+    for (uint8_t i = 0; i < motor_count; i++)
+    {
+        motors[i].waitTxDone();
+    }
+
+    // Frame rate with back to back sends, round robin, so all channels send in parallel
+    tx_end_interrupts = 0;
+    const uint32_t start_us = micros();
+
+    for (int frame = 0; frame < FRAMES_PER_MOTOR; frame++)
+    {
+        for (uint8_t i = 0; i < motor_count; i++)
+        {
+            motors[i].sendThrottleValue(DSHOT_THROTTLE_MIN);
+        }
+    }
+
+    for (uint8_t i = 0; i < motor_count; i++)
+    {
+        motors[i].waitTxDone();
+    }
+
+    const uint32_t duration_us = max(static_cast<uint32_t>(micros() - start_us), static_cast<uint32_t>(1));
+    const uint32_t interrupts_per_100_frames = (tx_end_interrupts * 100) / (FRAMES_PER_MOTOR * motor_count);
+
+    USB_Serial.printf("%6d | %-9s | %5d | %11u | %14u | %6u.%02u | %11d\n",
+                      motor_count,
+                      dshot_mode_name[dshot_mode],
+                      is_bidirectional,
+                      static_cast<unsigned>(send_cycles / (FRAMES_PER_MOTOR * motor_count)),
+                      static_cast<unsigned>((static_cast<uint64_t>(FRAMES_PER_MOTOR) * 1000000) / duration_us),
+                      static_cast<unsigned>(interrupts_per_100_frames / 100),
+                      static_cast<unsigned>(interrupts_per_100_frames % 100),
+                      static_cast<int>(heap_used));
+}
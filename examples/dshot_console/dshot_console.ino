@@ -0,0 +1,53 @@
+/*
+ * Title: dshot_console.ino
+ * Author: derdoktor667
+ * Date: 2026-10-18
+ *
+ * Description: Commissioning a motor with the DShotConsole. Type "help"
+ * on the USB serial port to list the commands. The application throttle
+ * is sent unless the console has taken it over.
+ */
+
+#include <Arduino.h>
+#include "DShotRMT.h"
+#include "DShotConsole.h"
+
+// USB serial port needed for this example
+const auto USB_SERIAL_BAUD = 115200;
+#define USB_Serial Serial
+
+// Define the GPIO pin connected to the motor and the DShot protocol used
+const auto MOTOR01_PIN = GPIO_NUM_4;
+const auto DSHOT_MODE = DSHOT300;
+
+// Throttle sent while the console is idle
+const auto IDLE_THROTTLE = 48;
+
+// Initialize a DShotRMT object for the motor
+DShotRMT motor01(MOTOR01_PIN, RMT_CHANNEL_0);
+
+// Attach the console to the motor and the USB serial port
+DShotConsole console(motor01, USB_Serial);
+
+void setup()
+{
+    USB_Serial.begin(USB_SERIAL_BAUD);
+
+    // Start generating DShot signal for the motor
+    motor01.begin(DSHOT_MODE);
+
+    // Start the console output task
+    console.begin();
+}
+
+void loop()
+{
+    // Parse console input without blocking the frame loop
+    console.update();
+
+    // Send the console throttle if it has taken over, otherwise the idle throttle
+    uint16_t throttle_value = IDLE_THROTTLE;
+    console.getThrottle(throttle_value);
+
+    motor01.sendThrottleValue(throttle_value);
+}
@@ -0,0 +1,540 @@
+//
+// Name:        fleet_simulator.cpp
+// Created: 	18.10.2026 16:05:12
+// Author:  	derdoktor667
+//
+// Runs thousands of independent DShotRMT instances, each on its own simulated
+// RMT peripheral with a virtual ESC on the line, across all CPU cores. Every
+// instance runs a randomized session of throttle, command and 3D frames with
+// random mode, limiter, throttle map and line noise. Reports the throughput,
+// the decode error rate on noisy lines and every invariant violation.
+//
+
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <DShotRMT.h>
+#include "host/virtual_rmt.h"
+#include "host_benchmark.h"
+#include "predictor_benchmark.h"
+#include "reversal_scenario.h"
+#include "virtual_esc.h"
+#include "work_stealing_pool.h"
+
+// Defaults of the command line options
+constexpr auto FLEET_DEFAULT_INSTANCES = 2000;
+constexpr auto FLEET_DEFAULT_FRAMES = 2000;       // Average frames per session
+constexpr auto FLEET_DEFAULT_SEED = 0x05EED001;
+constexpr auto FLEET_VIOLATIONS_PRINTED = 10;     // Further violations are only counted
+constexpr auto FLEET_TELEMETRY_INTERVAL = 64;     // Frames between two telemetry updates
+constexpr auto FLEET_RMT_TICK_NS = (1000000000ULL / RMT_CYCLES_PER_SEC);
+
+// Nominal bit timing per dshot_mode_t in RMT ticks, independent of the library
+static const uint16_t expected_ticks_per_bit[] = {0, 64, 32, 16, 8};
+static const uint16_t expected_ticks_zero_high[] = {0, 24, 12, 6, 3};
+static const uint16_t expected_ticks_one_high[] = {0, 48, 24, 12, 6};
+
+// Random setup of a single instance
+typedef struct fleet_instance_s
+{
+    dshot_mode_t mode;
+    bool is_bidirectional;
+    uint8_t pin;
+    uint8_t channel;
+    uint16_t jitter_ticks; // 0 for a clean line
+    bool use_throttle_map;
+    float thrust_expo;
+    bool use_limiter;
+    dshot_limiter_config_t limiter_config;
+    uint16_t deadband_3d;
+    uint32_t frames;
+} fleet_instance_t;
+
+// Counters of a worker, merged after the run
+typedef struct alignas(64) fleet_stats_s
+{
+    uint64_t sessions;
+    uint64_t frames;
+    uint64_t noisy_frames;
+    uint64_t decode_errors;        // Frames rejected by the ESC on a noisy line
+    uint64_t undetected_errors;    // Corrupted frames with a valid checksum on a noisy line
+    uint64_t invariant_violations; // Anything wrong on a clean line or in the library state
+    uint64_t simulated_ns;         // Wire time of all frames
+} fleet_stats_t;
+
+// Kind of frame sent in a session
+typedef enum fleet_frame_e
+{
+    FRAME_THROTTLE,
+    FRAME_COMMAND,
+    FRAME_3D,
+} fleet_frame_t;
+
+static uint32_t fleet_seed = FLEET_DEFAULT_SEED;
+static uint32_t fleet_frames = FLEET_DEFAULT_FRAMES;
+static std::mutex violation_mutex;
+static uint32_t violations_printed = 0;
+
+// Counts a violation and prints the first ones
+static void reportViolation(fleet_stats_t &stats, size_t instance, const fleet_instance_t &setup, const char *format, ...)
+{
+    stats.invariant_violations++;
+
+    std::lock_guard<std::mutex> lock(violation_mutex);
+
+    if (violations_printed >= FLEET_VIOLATIONS_PRINTED)
+    {
+        return;
+    }
+
+    violations_printed++;
+
+    char message[160];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+
+    printf("violation: instance %zu (%s%s, channel %u, jitter %u): %s\n",
+           instance, dshot_mode_name[setup.mode], setup.is_bidirectional ? " bidirectional" : "",
+           setup.channel, setup.jitter_ticks, message);
+}
+
+// Derives the setup of an instance from the seed, so every run is reproducible
+static fleet_instance_t createInstance(std::mt19937 &rng)
+{
+    fleet_instance_t setup = {};
+
+    setup.mode = static_cast<dshot_mode_t>(DSHOT150 + rng() % 4);
+    setup.is_bidirectional = rng() % 2;
+    setup.pin = rng() % 40;
+    setup.channel = rng() % RMT_CHANNEL_MAX;
+
+    // Half of the instances run on a noisy line
+    if (rng() % 2)
+    {
+        setup.jitter_ticks = 1 + rng() % max(1, expected_ticks_per_bit[setup.mode] / 8);
+    }
+
+    setup.use_throttle_map = (rng() % 4) == 0;
+    setup.thrust_expo = (rng() % 101) / 100.0f;
+
+    setup.use_limiter = (rng() % 4) == 0;
+    setup.limiter_config.current_soft_limit = 1000 + rng() % 2000;
+    setup.limiter_config.current_hard_limit = setup.limiter_config.current_soft_limit + rng() % 2000;
+    setup.limiter_config.temperature_soft_limit = 60 + rng() % 40;
+    setup.limiter_config.temperature_hard_limit = setup.limiter_config.temperature_soft_limit + rng() % 30;
+
+    setup.deadband_3d = (rng() % 8 == 0) ? (rng() % 1200) : (rng() % 50);
+    setup.frames = max(1u, fleet_frames / 2 + static_cast<uint32_t>(rng() % (fleet_frames + 1)));
+
+    return setup;
+}
+
+// Checks the bit timing of a frame decoded from a clean line
+static bool isTimingValid(const virtual_esc_frame_t &frame, dshot_mode_t mode)
+{
+    const bool has_zero = (frame.zero_ticks > 0);
+    const bool has_one = (frame.one_ticks != UINT16_MAX);
+
+    return (frame.bit_ticks == expected_ticks_per_bit[mode]) &&
+           (!has_zero || (frame.zero_ticks == expected_ticks_zero_high[mode])) &&
+           (!has_one || (frame.one_ticks == expected_ticks_one_high[mode]));
+}
+
+// Feeds eRPM telemetry with duplicate and late samples into a predictor
+static void runErpmSession(std::mt19937 &rng, fleet_stats_t &stats, size_t instance, const fleet_instance_t &setup)
+{
+    DShotErpmPredictor<1> erpm_predictor;
+    uint32_t sample_time_us = rng(); // Any start, so the timestamps wrap in some sessions
+    int32_t erpm = rng() % 50000;
+
+    for (uint32_t sample = 0; sample < (setup.frames / FLEET_TELEMETRY_INTERVAL) + 2; sample++)
+    {
+        if ((sample > 1) && (rng() % 8 == 0))
+        {
+            const uint32_t predicted = erpm_predictor.predict(0, sample_time_us + 100);
+            erpm_predictor.update(0, rng() % 50000, sample_time_us - rng() % 3000);
+
+            if (erpm_predictor.predict(0, sample_time_us + 100) != predicted)
+            {
+                reportViolation(stats, instance, setup, "eRPM prediction changed by a stale sample");
+            }
+            continue;
+        }
+
+        sample_time_us += 500 + rng() % 1000;
+        erpm = max(erpm + static_cast<int32_t>(rng() % 2001) - 1000, 0);
+        erpm_predictor.update(0, erpm, sample_time_us);
+
+        if (erpm_predictor.predict(0, sample_time_us) != static_cast<uint32_t>(erpm))
+        {
+            reportViolation(stats, instance, setup, "eRPM prediction at the sample time is not the sample");
+        }
+    }
+}
+
+// Runs one randomized session of a DShotRMT instance against a virtual ESC
+static void runSession(size_t instance, fleet_stats_t &stats)
+{
+    std::mt19937 rng(fleet_seed ^ static_cast<uint32_t>(instance * 0x9E3779B9u));
+    fleet_instance_t setup = createInstance(rng);
+
+    VirtualEsc esc;
+    VirtualRmt rmt(esc);
+
+    esc.setNoise(setup.jitter_ticks, rng());
+    rmt.makeCurrent();
+
+    {
+        DShotRMT motor(setup.pin, setup.channel);
+
+        if (!motor.begin(setup.mode, setup.is_bidirectional))
+        {
+            reportViolation(stats, instance, setup, "begin() failed");
+        }
+
+        // Calibration must not touch a channel in use, the own one or another motor's
+        const uint8_t other_channel = (setup.channel + 1 + rng() % (RMT_CHANNEL_MAX - 1)) % RMT_CHANNEL_MAX;
+        DShotRMT other_motor((setup.pin + 1) % 40, other_channel);
+
+        const uint8_t rx_case = rng() % 3; // 0: own channel, 1: other motor's channel, 2: free channel
+        const rmt_channel_t rx_channel = static_cast<rmt_channel_t>((rx_case == 0) ? setup.channel : other_channel);
+
+        if ((rx_case == 1) && !other_motor.begin(DSHOT300))
+        {
+            reportViolation(stats, instance, setup, "begin() of a second motor failed");
+        }
+
+        // The host has no RX data, so calibration never succeeds
+        if (motor.calibrateTiming(rx_channel))
+        {
+            reportViolation(stats, instance, setup, "calibration succeeded without RX data");
+        }
+
+        if ((rx_case < 2) && (rmt.channels[rx_channel].config.rmt_mode != RMT_MODE_TX))
+        {
+            reportViolation(stats, instance, setup, "calibration switched channel %u in use to RX", rx_channel);
+        }
+
+        if ((rx_case == 2) && rmt.channels[rx_channel].is_installed)
+        {
+            reportViolation(stats, instance, setup, "calibration left RX channel %u installed", rx_channel);
+        }
+
+        // Tables with an entry outside the throttle range must be rejected
+        std::vector<uint16_t> throttle_map(DSHOT_THROTTLE_RANGE);
+        DShotRMT::buildThrustLinearizationMap(throttle_map.data(), setup.thrust_expo);
+
+        std::vector<uint16_t> invalid_map(throttle_map);
+        invalid_map[rng() % DSHOT_THROTTLE_RANGE] = rng() % DSHOT_THROTTLE_MIN;
+
+        if (motor.setThrottleMap(invalid_map.data()))
+        {
+            reportViolation(stats, instance, setup, "throttle map with a command entry accepted");
+        }
+
+        if (setup.use_throttle_map && !motor.setThrottleMap(throttle_map.data()))
+        {
+            reportViolation(stats, instance, setup, "valid throttle map rejected");
+        }
+
+        if (setup.use_limiter)
+        {
+            motor.setLimiter(setup.limiter_config);
+        }
+
+        motor.set3DDeadband(setup.deadband_3d);
+        const int32_t deadband_3d = min<int32_t>(setup.deadband_3d, DSHOT_3D_THROTTLE_SIGNED_MAX - 2);
+
+        for (uint32_t frame = 0; frame < setup.frames; frame++)
+        {
+            // Change the mode once per session, the channel has to be reinstalled
+            if (frame == setup.frames / 2)
+            {
+                setup.mode = static_cast<dshot_mode_t>(DSHOT150 + rng() % 4);
+
+                if (!motor.begin(setup.mode, setup.is_bidirectional))
+                {
+                    reportViolation(stats, instance, setup, "begin() failed on mode change");
+                }
+            }
+
+            // Telemetry from the ESC drives the limiter
+            if (setup.use_limiter && (frame % FLEET_TELEMETRY_INTERVAL) == 0)
+            {
+                const uint16_t current = rng() % 5000;
+                const uint8_t temperature = rng() % 130;
+                const dshot_limiter_config_t &limits = setup.limiter_config;
+
+                motor.updateTelemetry(current, temperature);
+                const uint16_t scale = motor.getLimiterStats().throttle_scale;
+
+                // The hard limit wins if both limits are the same
+                const bool is_beyond = (current >= limits.current_hard_limit) || (temperature >= limits.temperature_hard_limit);
+                const bool is_within = !is_beyond && (current <= limits.current_soft_limit) && (temperature <= limits.temperature_soft_limit);
+
+                if ((scale > DSHOT_LIMITER_SCALE_FULL) || (is_within && scale != DSHOT_LIMITER_SCALE_FULL) || (is_beyond && scale != 0))
+                {
+                    reportViolation(stats, instance, setup, "limiter scale %u for %u cA, %u C", scale, current, temperature);
+                }
+            }
+
+            const uint16_t scale = motor.getLimiterStats().throttle_scale;
+            const uint32_t frames_limited = motor.getLimiterStats().frames_limited;
+            const fleet_frame_t frame_type = static_cast<fleet_frame_t>((rng() % 10 < 7) ? FRAME_THROTTLE : (rng() % 3 == 0) ? FRAME_COMMAND : FRAME_3D);
+
+            uint16_t expected_min = 0, expected_max = 0;
+            bool expected_telemetric_request = false;
+            int32_t requested = 0;
+
+            switch (frame_type)
+            {
+            case FRAME_THROTTLE:
+            {
+                requested = rng() % 2200;
+                motor.sendThrottleValue(requested);
+
+                int32_t throttle_value = constrain(requested, DSHOT_THROTTLE_MIN, DSHOT_THROTTLE_MAX);
+
+                if (scale < DSHOT_LIMITER_SCALE_FULL)
+                {
+                    throttle_value = DSHOT_THROTTLE_MIN + ((throttle_value - DSHOT_THROTTLE_MIN) * scale) / DSHOT_LIMITER_SCALE_FULL;
+                }
+
+                if (setup.use_throttle_map)
+                {
+                    throttle_value = throttle_map[throttle_value - DSHOT_THROTTLE_MIN];
+                }
+
+                expected_min = expected_max = throttle_value;
+                break;
+            }
+
+            case FRAME_COMMAND:
+                requested = rng() % (DSHOT_CMD_MAX + 1);
+                motor.sendCommand(static_cast<dshot_cmd_t>(requested));
+
+                expected_min = expected_max = requested;
+                expected_telemetric_request = true;
+                break;
+
+            case FRAME_3D:
+            {
+                requested = static_cast<int32_t>(rng() % 2201) - 1100;
+                motor.sendThrottle3D(requested);
+
+                int32_t throttle_value = constrain(requested, -DSHOT_3D_THROTTLE_SIGNED_MAX, DSHOT_3D_THROTTLE_SIGNED_MAX);
+
+                if (scale < DSHOT_LIMITER_SCALE_FULL)
+                {
+                    throttle_value = (throttle_value * scale) / DSHOT_LIMITER_SCALE_FULL;
+                }
+
+                const int32_t magnitude = abs(throttle_value);
+
+                // Stop within the deadband, both ends of each direction reachable
+                if (magnitude <= deadband_3d)
+                {
+                    expected_min = expected_max = DSHOT_CMD_MOTOR_STOP;
+                }
+                else if (throttle_value > 0)
+                {
+                    expected_min = (magnitude == DSHOT_3D_THROTTLE_SIGNED_MAX) ? DSHOT_3D_THROTTLE_FORWARD_MAX : DSHOT_3D_THROTTLE_FORWARD_MIN;
+                    expected_max = (magnitude == deadband_3d + 1) ? DSHOT_3D_THROTTLE_FORWARD_MIN : DSHOT_3D_THROTTLE_FORWARD_MAX;
+                }
+                else
+                {
+                    expected_min = (magnitude == DSHOT_3D_THROTTLE_SIGNED_MAX) ? DSHOT_3D_THROTTLE_REVERSE_MAX : DSHOT_3D_THROTTLE_REVERSE_MIN;
+                    expected_max = (magnitude == deadband_3d + 1) ? DSHOT_3D_THROTTLE_REVERSE_MIN : DSHOT_3D_THROTTLE_REVERSE_MAX;
+                }
+                break;
+            }
+            }
+
+            // Limited throttle and 3D frames are counted, nothing else
+            const bool is_limited = (frame_type != FRAME_COMMAND) && (scale < DSHOT_LIMITER_SCALE_FULL);
+
+            if (motor.getLimiterStats().frames_limited != frames_limited + (is_limited ? 1 : 0))
+            {
+                reportViolation(stats, instance, setup, "frames_limited not counted");
+            }
+
+            stats.frames++;
+            stats.simulated_ns += static_cast<uint64_t>(expected_ticks_per_bit[setup.mode]) * DSHOT_PAUSE_BIT * FLEET_RMT_TICK_NS;
+
+            virtual_esc_frame_t esc_frame;
+            const virtual_esc_decode_t result = esc.takeFrame(esc_frame);
+
+            const bool is_expected = (result == ESC_DECODE_SUCCESS) &&
+                                     (esc_frame.value >= expected_min) && (esc_frame.value <= expected_max) &&
+                                     (esc_frame.telemetric_request == expected_telemetric_request) &&
+                                     (esc_frame.is_inverted == setup.is_bidirectional);
+
+            if (setup.jitter_ticks > 0)
+            {
+                stats.noisy_frames++;
+
+                if (result != ESC_DECODE_SUCCESS)
+                {
+                    stats.decode_errors++;
+                }
+                else if (!is_expected)
+                {
+                    stats.undetected_errors++;
+                }
+            }
+            else if (result != ESC_DECODE_SUCCESS)
+            {
+                reportViolation(stats, instance, setup, "frame %u (request %d) not decoded, error %d", frame, requested, result);
+            }
+            else if (!is_expected)
+            {
+                reportViolation(stats, instance, setup, "frame %u (request %d) decoded as %u%s, expected %u - %u",
+                                frame, requested, esc_frame.value, esc_frame.telemetric_request ? " with telemetric bit" : "", expected_min, expected_max);
+            }
+            else if (!isTimingValid(esc_frame, setup.mode))
+            {
+                reportViolation(stats, instance, setup, "frame %u bit timing %u/%u/%u ticks", frame, esc_frame.bit_ticks, esc_frame.zero_ticks, esc_frame.one_ticks);
+            }
+        }
+    }
+
+    // The destructor has uninstalled the channel again
+    if (rmt.channels[setup.channel].is_installed)
+    {
+        reportViolation(stats, instance, setup, "channel still installed after destruction");
+    }
+
+    if (rmt.api_errors > 0)
+    {
+        reportViolation(stats, instance, setup, "%u RMT driver calls failed", rmt.api_errors);
+    }
+
+    VirtualRmt::clearCurrent();
+    runErpmSession(rng, stats, instance, setup);
+    stats.sessions++;
+}
+
+// What a run of the tool does
+typedef enum fleet_run_mode_e
+{
+    FLEET_RUN_FLEET = 0, // Randomized sessions of many instances
+    FLEET_RUN_REVERSAL,  // 3D reversal latency with the motor model
+    FLEET_RUN_PREDICTOR, // Accuracy and cost of the eRPM predictor
+    FLEET_RUN_BENCHMARK, // Workloads of examples/dshot_benchmark
+} fleet_run_mode_t;
+
+static void printUsage(const char *name)
+{
+    printf("usage: %s [--instances N] [--frames N] [--threads N] [--seed N]\n", name);
+    printf("       %s --reversal\n", name);
+    printf("       %s --predictor [--seed N]\n", name);
+    printf("       %s --benchmark\n", name);
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t instances = FLEET_DEFAULT_INSTANCES;
+    unsigned threads = std::thread::hardware_concurrency();
+    fleet_run_mode_t run_mode = FLEET_RUN_FLEET;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const bool has_value = (i + 1 < argc);
+
+        if (strcmp(argv[i], "--reversal") == 0)
+        {
+            run_mode = FLEET_RUN_REVERSAL;
+        }
+        else if (strcmp(argv[i], "--predictor") == 0)
+        {
+            run_mode = FLEET_RUN_PREDICTOR;
+        }
+        else if (strcmp(argv[i], "--benchmark") == 0)
+        {
+            run_mode = FLEET_RUN_BENCHMARK;
+        }
+        else if (has_value && strcmp(argv[i], "--instances") == 0)
+        {
+            instances = strtoul(argv[++i], nullptr, 0);
+        }
+        else if (has_value && strcmp(argv[i], "--frames") == 0)
+        {
+            fleet_frames = strtoul(argv[++i], nullptr, 0);
+        }
+        else if (has_value && strcmp(argv[i], "--threads") == 0)
+        {
+            threads = strtoul(argv[++i], nullptr, 0);
+        }
+        else if (has_value && strcmp(argv[i], "--seed") == 0)
+        {
+            fleet_seed = strtoul(argv[++i], nullptr, 0);
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (run_mode == FLEET_RUN_REVERSAL)
+    {
+        return (runReversalScenarios() == 0) ? 0 : 1;
+    }
+
+    if (run_mode == FLEET_RUN_PREDICTOR)
+    {
+        return (runPredictorBenchmark(fleet_seed) == 0) ? 0 : 1;
+    }
+
+    if (run_mode == FLEET_RUN_BENCHMARK)
+    {
+        return (runHostBenchmark() == 0) ? 0 : 1;
+    }
+
+    WorkStealingPool pool(threads);
+    std::vector<fleet_stats_t> worker_stats(pool.getWorkerCount());
+
+    printf("DShotRMT %s fleet simulator: %u instances, ~%u frames each, %u workers, seed 0x%08X\n",
+           DSHOT_LIB_VERSION, instances, fleet_frames, pool.getWorkerCount(), fleet_seed);
+
+    const auto start = std::chrono::steady_clock::now();
+
+    pool.run(instances, [&worker_stats](unsigned worker, size_t instance)
+             { runSession(instance, worker_stats[worker]); });
+
+    const double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    fleet_stats_t total = {};
+
+    for (const auto &stats : worker_stats)
+    {
+        total.sessions += stats.sessions;
+        total.frames += stats.frames;
+        total.noisy_frames += stats.noisy_frames;
+        total.decode_errors += stats.decode_errors;
+        total.undetected_errors += stats.undetected_errors;
+        total.invariant_violations += stats.invariant_violations;
+        total.simulated_ns += stats.simulated_ns;
+    }
+
+    const double simulated_s = total.simulated_ns / 1e9;
+    const double noisy_frames = max<double>(total.noisy_frames, 1);
+
+    printf("sessions:             %llu (%llu stolen)\n", static_cast<unsigned long long>(total.sessions), static_cast<unsigned long long>(pool.getSteals()));
+    printf("frames:               %llu in %.3f s, %.0f frames/s\n", static_cast<unsigned long long>(total.frames), wall_s, total.frames / max(wall_s, 1e-9));
+    printf("simulated wire time:  %.3f s, %.1fx real time\n", simulated_s, simulated_s / max(wall_s, 1e-9));
+    printf("decode errors:        %llu of %llu noisy frames (%.3f %%)\n",
+           static_cast<unsigned long long>(total.decode_errors), static_cast<unsigned long long>(total.noisy_frames), 100.0 * total.decode_errors / noisy_frames);
+    printf("undetected errors:    %llu (%.3f %%)\n", static_cast<unsigned long long>(total.undetected_errors), 100.0 * total.undetected_errors / noisy_frames);
+    printf("invariant violations: %llu\n", static_cast<unsigned long long>(total.invariant_violations));
+
+    return (total.invariant_violations == 0) ? 0 : 1;
+}
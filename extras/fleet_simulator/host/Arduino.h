@@ -0,0 +1,63 @@
+//
+// Name:        Arduino.h
+// Created: 	18.10.2026 16:05:12
+// Author:  	derdoktor667
+//
+// Host replacement of the Arduino core, just enough to build DShotRMT.cpp
+// for the fleet simulator.
+//
+
+#ifndef _HOST_ARDUINO_h
+#define _HOST_ARDUINO_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+using std::max;
+using std::min;
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+// Clocks of the ESP32
+#define APB_CLK_FREQ 80000000
+#define F_CPU 240000000L
+
+// ESP-IDF error codes
+typedef int esp_err_t;
+#define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_ERR_INVALID_ARG 0x102
+#define ESP_ERR_INVALID_STATE 0x103
+
+// FreeRTOS ticks are milliseconds on the host
+typedef uint32_t TickType_t;
+#define pdMS_TO_TICKS(ms) (static_cast<TickType_t>(ms))
+#define portMAX_DELAY 0xFFFFFFFF
+
+// The RMT RX ringbuffer is not simulated, receiving always times out
+typedef void *RingbufHandle_t;
+void *xRingbufferReceive(RingbufHandle_t ringbuf, size_t *item_size, TickType_t ticks_to_wait);
+void vRingbufferReturnItem(RingbufHandle_t ringbuf, void *item);
+
+// GPIO matrix
+typedef enum
+{
+    GPIO_NUM_NC = -1,
+    GPIO_NUM_0 = 0,
+    GPIO_NUM_MAX = 49,
+} gpio_num_t;
+
+typedef enum
+{
+    GPIO_MODE_INPUT = 1,
+    GPIO_MODE_OUTPUT = 2,
+    GPIO_MODE_INPUT_OUTPUT = 3,
+} gpio_mode_t;
+
+esp_err_t gpio_set_direction(gpio_num_t gpio_num, gpio_mode_t mode);
+
+#endif
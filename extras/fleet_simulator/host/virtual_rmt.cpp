@@ -0,0 +1,207 @@
+//
+// Name:        virtual_rmt.cpp
+// Created: 	18.10.2026 16:05:12
+// Author:  	derdoktor667
+//
+
+#include "virtual_rmt.h"
+
+// The device the driver functions act on, one per thread
+static thread_local VirtualRmt *current_rmt = nullptr;
+
+VirtualRmt::VirtualRmt(VirtualRmtSink &sink)
+    : channels{},
+      sink(sink),
+      api_errors(0)
+{
+}
+
+void VirtualRmt::makeCurrent()
+{
+    current_rmt = this;
+}
+
+VirtualRmt *VirtualRmt::current()
+{
+    return current_rmt;
+}
+
+void VirtualRmt::clearCurrent()
+{
+    current_rmt = nullptr;
+}
+
+// Returns the channel of the current device or nullptr for invalid calls
+static virtual_rmt_channel_t *getChannel(rmt_channel_t channel)
+{
+    if ((current_rmt == nullptr) || (channel < RMT_CHANNEL_0) || (channel >= RMT_CHANNEL_MAX))
+    {
+        return nullptr;
+    }
+
+    return &current_rmt->channels[channel];
+}
+
+// Counts a call violating the driver contract and returns its error code
+static esp_err_t apiError(esp_err_t error)
+{
+    if (current_rmt != nullptr)
+    {
+        current_rmt->api_errors++;
+    }
+
+    return error;
+}
+
+esp_err_t rmt_config(const rmt_config_t *rmt_param)
+{
+    virtual_rmt_channel_t *rmt_channel = (rmt_param != nullptr) ? getChannel(rmt_param->channel) : nullptr;
+
+    if (rmt_channel == nullptr)
+    {
+        return apiError(ESP_ERR_INVALID_ARG);
+    }
+
+    rmt_channel->config = *rmt_param;
+    rmt_channel->is_configured = true;
+
+    return ESP_OK;
+}
+
+esp_err_t rmt_driver_install(rmt_channel_t channel, size_t, int)
+{
+    virtual_rmt_channel_t *rmt_channel = getChannel(channel);
+
+    if (rmt_channel == nullptr)
+    {
+        return apiError(ESP_ERR_INVALID_ARG);
+    }
+
+    // Installing twice fails like on the target
+    if (!rmt_channel->is_configured || rmt_channel->is_installed)
+    {
+        return apiError(ESP_ERR_INVALID_STATE);
+    }
+
+    rmt_channel->is_installed = true;
+
+    return ESP_OK;
+}
+
+esp_err_t rmt_driver_uninstall(rmt_channel_t channel)
+{
+    virtual_rmt_channel_t *rmt_channel = getChannel(channel);
+
+    if (rmt_channel == nullptr)
+    {
+        return apiError(ESP_ERR_INVALID_ARG);
+    }
+
+    if (!rmt_channel->is_installed)
+    {
+        return apiError(ESP_ERR_INVALID_STATE);
+    }
+
+    rmt_channel->is_installed = false;
+
+    return ESP_OK;
+}
+
+esp_err_t rmt_write_items(rmt_channel_t channel, const rmt_item32_t *rmt_item, int item_num, bool)
+{
+    virtual_rmt_channel_t *rmt_channel = getChannel(channel);
+
+    if ((rmt_channel == nullptr) || (rmt_item == nullptr) || (item_num <= 0))
+    {
+        return apiError(ESP_ERR_INVALID_ARG);
+    }
+
+    if (!rmt_channel->is_installed || (rmt_channel->config.rmt_mode != RMT_MODE_TX))
+    {
+        return apiError(ESP_ERR_INVALID_STATE);
+    }
+
+    // Frames are sent instantly, no waiting for the wire
+    current_rmt->sink.onRmtWrite(channel, rmt_channel->config, rmt_item, item_num);
+
+    return ESP_OK;
+}
+
+esp_err_t rmt_wait_tx_done(rmt_channel_t channel, TickType_t)
+{
+    return (getChannel(channel) != nullptr) ? ESP_OK : apiError(ESP_ERR_INVALID_ARG);
+}
+
+esp_err_t rmt_get_ringbuf_handle(rmt_channel_t channel, RingbufHandle_t *buf_handle)
+{
+    if (buf_handle != nullptr)
+    {
+        *buf_handle = nullptr;
+    }
+
+    return (getChannel(channel) != nullptr) ? ESP_OK : apiError(ESP_ERR_INVALID_ARG);
+}
+
+esp_err_t rmt_rx_start(rmt_channel_t channel, bool)
+{
+    return (getChannel(channel) != nullptr) ? ESP_OK : apiError(ESP_ERR_INVALID_ARG);
+}
+
+esp_err_t rmt_rx_stop(rmt_channel_t channel)
+{
+    return (getChannel(channel) != nullptr) ? ESP_OK : apiError(ESP_ERR_INVALID_ARG);
+}
+
+esp_err_t rmt_set_gpio(rmt_channel_t channel, rmt_mode_t, gpio_num_t, bool)
+{
+    return (getChannel(channel) != nullptr) ? ESP_OK : apiError(ESP_ERR_INVALID_ARG);
+}
+
+esp_err_t rmt_set_mem_block_num(rmt_channel_t channel, uint8_t rmt_mem_num)
+{
+    virtual_rmt_channel_t *rmt_channel = getChannel(channel);
+
+    if (rmt_channel == nullptr)
+    {
+        return apiError(ESP_ERR_INVALID_ARG);
+    }
+
+    rmt_channel->config.mem_block_num = rmt_mem_num;
+
+    return ESP_OK;
+}
+
+esp_err_t rmt_get_channel_status(rmt_channel_status_result_t *channel_status)
+{
+    if ((current_rmt == nullptr) || (channel_status == nullptr))
+    {
+        return apiError(ESP_ERR_INVALID_ARG);
+    }
+
+    // Frames are sent instantly, so an installed channel is always idle
+    for (int channel = 0; channel < RMT_CHANNEL_MAX; channel++)
+    {
+        channel_status->status[channel] = current_rmt->channels[channel].is_installed ? RMT_CHANNEL_IDLE : RMT_CHANNEL_UNINIT;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_direction(gpio_num_t, gpio_mode_t)
+{
+    return ESP_OK;
+}
+
+void *xRingbufferReceive(RingbufHandle_t, size_t *item_size, TickType_t)
+{
+    if (item_size != nullptr)
+    {
+        *item_size = 0;
+    }
+
+    return nullptr;
+}
+
+void vRingbufferReturnItem(RingbufHandle_t, void *)
+{
+}
@@ -0,0 +1,46 @@
+//
+// Name:        virtual_rmt.h
+// Created: 	18.10.2026 16:05:12
+// Author:  	derdoktor667
+//
+
+#ifndef _VIRTUAL_RMT_h
+#define _VIRTUAL_RMT_h
+
+#include <driver/rmt.h>
+
+// Receives every frame written to an installed channel of a VirtualRmt
+class VirtualRmtSink
+{
+public:
+    virtual ~VirtualRmtSink() = default;
+    virtual void onRmtWrite(rmt_channel_t channel, const rmt_config_t &config, const rmt_item32_t *items, int item_count) = 0;
+};
+
+// State of a single simulated RMT channel
+typedef struct virtual_rmt_channel_s
+{
+    rmt_config_t config;
+    bool is_configured;
+    bool is_installed;
+} virtual_rmt_channel_t;
+
+// One simulated RMT peripheral. The driver functions of driver/rmt.h act on the
+// VirtualRmt made current on the calling thread, so every worker thread can run
+// its own independent device.
+class VirtualRmt
+{
+public:
+    explicit VirtualRmt(VirtualRmtSink &sink);
+
+    // Makes this device the target of the driver functions on the calling thread.
+    void makeCurrent();
+    static VirtualRmt *current();
+    static void clearCurrent();
+
+    virtual_rmt_channel_t channels[RMT_CHANNEL_MAX]; // The simulated channels.
+    VirtualRmtSink &sink;                            // Receives the written frames.
+    uint32_t api_errors;                             // Calls violating the driver contract, e.g. writing to an uninstalled channel.
+};
+
+#endif
@@ -0,0 +1,142 @@
+//
+// Name:        host_benchmark.cpp
+// Created: 	18.10.2026 16:05:12
+// Author:  	derdoktor667
+//
+
+#include <chrono>
+#include <cstdio>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCHMARK_HAS_TSC 1
+#endif
+
+#include <DShotRMT.h>
+#include "host/virtual_rmt.h"
+#include "host_benchmark.h"
+
+constexpr auto BENCHMARK_FRAMES_PER_MOTOR = 20000;
+
+// Workloads of the benchmark, the same as in examples/dshot_benchmark
+static const uint8_t motor_counts[] = {1, 2, 4, 8, 16};
+static const dshot_mode_t dshot_modes[] = {DSHOT150, DSHOT300, DSHOT600, DSHOT1200};
+static const bool bidirectional_modes[] = {false, true};
+
+// Counts the frames and their wire time, without decoding, so only the library is timed
+class BenchmarkSink : public VirtualRmtSink
+{
+public:
+    void onRmtWrite(rmt_channel_t, const rmt_config_t &config, const rmt_item32_t *items, int item_count) override
+    {
+        uint32_t frame_ticks = 0;
+
+        for (int i = 0; i < item_count; i++)
+        {
+            frame_ticks += items[i].duration0 + items[i].duration1;
+        }
+
+        frames++;
+        wire_ns = (static_cast<uint64_t>(frame_ticks) * config.clk_div * 1000000000ULL) / F_CPU_RMT;
+    }
+
+    uint32_t frames = 0;  // Frames written.
+    uint64_t wire_ns = 0; // Wire time of the last frame incl. the pause.
+};
+
+// Sends BENCHMARK_FRAMES_PER_MOTOR frames to each motor of a group and prints one table row
+static unsigned runWorkload(uint8_t motor_count, dshot_mode_t dshot_mode, bool is_bidirectional)
+{
+    BenchmarkSink sink;
+    VirtualRmt rmt(sink);
+    rmt.makeCurrent();
+
+    DShotRMT motors[] = {
+        DShotRMT(4, 0), DShotRMT(5, 1), DShotRMT(13, 2), DShotRMT(14, 3),
+        DShotRMT(18, 4), DShotRMT(19, 5), DShotRMT(21, 6), DShotRMT(22, 7)};
+    DShotRMT *const motor_group[] = {&motors[0], &motors[1], &motors[2], &motors[3], &motors[4], &motors[5], &motors[6], &motors[7]};
+
+    unsigned violations = 0;
+
+    if (!DShotRMT::beginGroup(motor_group, motor_count, dshot_mode, is_bidirectional))
+    {
+        printf("%6d | %-9s | %5d | begin failed\n", motor_count, dshot_mode_name[dshot_mode], is_bidirectional);
+        VirtualRmt::clearCurrent();
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+#ifdef BENCHMARK_HAS_TSC
+    const uint64_t start_cycles = __rdtsc();
+#endif
+
+    for (int frame = 0; frame < BENCHMARK_FRAMES_PER_MOTOR; frame++)
+    {
+        for (uint8_t i = 0; i < motor_count; i++)
+        {
+            motors[i].sendThrottleValue(DSHOT_THROTTLE_MIN);
+        }
+    }
+
+#ifdef BENCHMARK_HAS_TSC
+    const uint64_t send_cycles = __rdtsc() - start_cycles;
+#else
+    const uint64_t send_cycles = 0;
+#endif
+    const uint64_t send_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    const uint32_t sends = BENCHMARK_FRAMES_PER_MOTOR * motor_count;
+
+    // Channels send in parallel, so the frame rate per motor is set by the wire time of a frame
+    printf("%6d | %-9s | %5d | %8.1f | %10.1f | %14llu\n",
+           motor_count,
+           dshot_mode_name[dshot_mode],
+           is_bidirectional,
+           static_cast<double>(send_ns) / sends,
+           static_cast<double>(send_cycles) / sends,
+           static_cast<unsigned long long>(1000000000ULL / max<uint64_t>(sink.wire_ns, 1)));
+
+    if ((sink.frames != sends) || (rmt.api_errors > 0))
+    {
+        printf("VIOLATION %d motors %s: %u of %u frames sent, %u driver errors\n",
+               motor_count, dshot_mode_name[dshot_mode], sink.frames, sends, rmt.api_errors);
+        violations++;
+    }
+
+    for (uint8_t i = 0; i < motor_count; i++)
+    {
+        motors[i].end();
+    }
+
+    VirtualRmt::clearCurrent();
+
+    return violations;
+}
+
+unsigned runHostBenchmark()
+{
+    unsigned violations = 0;
+
+    printf("DShotRMT %s host benchmark, %d frames per motor, %u bytes per motor object\n",
+           DSHOT_LIB_VERSION, BENCHMARK_FRAMES_PER_MOTOR, static_cast<unsigned>(sizeof(DShotRMT)));
+    printf("motors | mode      | bidir |  ns/send | TSC cycles | frames/s/motor\n");
+
+    for (const auto motor_count : motor_counts)
+    {
+        // ESP32 has the most RMT TX channels with 8, more motors need a second peripheral
+        if (motor_count > RMT_CHANNEL_MAX)
+        {
+            printf("%6d | not measured, more motors than the %d RMT TX channels, unreachable on the target\n", motor_count, RMT_CHANNEL_MAX);
+            continue;
+        }
+
+        for (const auto dshot_mode : dshot_modes)
+        {
+            for (const bool is_bidirectional : bidirectional_modes)
+            {
+                violations += runWorkload(motor_count, dshot_mode, is_bidirectional);
+            }
+        }
+    }
+
+    return violations;
+}
@@ -0,0 +1,18 @@
+//
+// Name:        host_benchmark.h
+// Created: 	18.10.2026 16:05:12
+// Author:  	derdoktor667
+//
+// The workloads of examples/dshot_benchmark on the host: 1 up to 16 motors,
+// every DShot mode, with and without bidirectional DShot.
+//
+
+#ifndef _HOST_BENCHMARK_h
+#define _HOST_BENCHMARK_h
+
+// Prints the CPU time per send and the frame rate on the wire of every
+// workload. Returns the number of violations, a failed begin or a lost frame
+// on a workload the target supports.
+unsigned runHostBenchmark();
+
+#endif
@@ -0,0 +1,189 @@
+//
+// Name:        predictor_benchmark.cpp
+// Created: 	18.10.2026 16:05:12
+// Author:  	derdoktor667
+//
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PREDICTOR_HAS_TSC 1
+#endif
+
+#include <DShotRMT.h>
+#include "host/virtual_rmt.h"
+#include "predictor_benchmark.h"
+#include "virtual_esc.h"
+
+constexpr auto PREDICTOR_LOOP_US = 125;           // Control loop period, 8 kHz
+constexpr auto PREDICTOR_SESSION_US = 10000000;   // Length of the modeled flight
+constexpr auto PREDICTOR_STEP_MIN_US = 20000;     // Shortest time between two throttle steps
+constexpr auto PREDICTOR_STEP_MAX_US = 80000;     // Longest time between two throttle steps
+constexpr auto PREDICTOR_TIMED_CALLS = 10000000;  // Calls per timed function
+constexpr auto PREDICTOR_TIMED_MOTORS = 4;
+
+// Telemetry sample interval per row
+static const uint32_t telemetry_intervals_us[] = {500, 1000, 2000};
+
+// Quad motor with light props
+static const virtual_motor_config_t predictor_motor = {false, 150000, 40000, 30000, 400000, 150000, 0};
+
+// Models a flight with random throttle steps, one eRPM value per control loop
+static std::vector<int32_t> modelTrajectory(uint32_t seed)
+{
+    VirtualEsc esc;
+    VirtualRmt rmt(esc);
+    std::mt19937 rng(seed);
+    std::vector<int32_t> trajectory;
+
+    rmt.makeCurrent();
+    esc.setMotor(predictor_motor);
+
+    DShotRMT motor(GPIO_NUM_0, RMT_CHANNEL_0);
+    motor.begin(DSHOT600, true);
+
+    uint16_t throttle_value = DSHOT_THROTTLE_MIN;
+    uint32_t next_step_us = 0;
+
+    for (uint32_t time_us = 0; time_us < PREDICTOR_SESSION_US; time_us += PREDICTOR_LOOP_US)
+    {
+        if (time_us >= next_step_us)
+        {
+            throttle_value = 200 + rng() % 1600;
+            next_step_us = time_us + PREDICTOR_STEP_MIN_US + rng() % (PREDICTOR_STEP_MAX_US - PREDICTOR_STEP_MIN_US);
+        }
+
+        motor.sendThrottleValue(throttle_value);
+        trajectory.push_back(esc.getErpm());
+        esc.advance(PREDICTOR_LOOP_US);
+    }
+
+    motor.end();
+    VirtualRmt::clearCurrent();
+
+    return trajectory;
+}
+
+// Replays the trajectory with telemetry every interval_us, arriving one loop late
+static unsigned measureAccuracy(const std::vector<int32_t> &trajectory, uint32_t interval_us)
+{
+    DShotErpmPredictor<1> erpm_predictor;
+    const uint32_t interval_loops = interval_us / PREDICTOR_LOOP_US;
+    uint32_t held_erpm = 0;
+    uint64_t predicted_error = 0;
+    uint64_t held_error = 0;
+    uint32_t predicted_error_max = 0;
+    uint32_t held_error_max = 0;
+    uint32_t queries = 0;
+
+    for (size_t loop = 1; loop < trajectory.size(); loop++)
+    {
+        const size_t sample_loop = loop - 1;
+
+        if ((sample_loop % interval_loops) == 0)
+        {
+            held_erpm = trajectory[sample_loop];
+            erpm_predictor.update(0, held_erpm, sample_loop * PREDICTOR_LOOP_US);
+        }
+
+        const uint32_t truth = trajectory[loop];
+        const uint32_t error = abs(static_cast<int32_t>(erpm_predictor.predict(0, loop * PREDICTOR_LOOP_US) - truth));
+        const uint32_t held = abs(static_cast<int32_t>(held_erpm - truth));
+
+        predicted_error += error;
+        held_error += held;
+        predicted_error_max = max(predicted_error_max, error);
+        held_error_max = max(held_error_max, held);
+        queries++;
+    }
+
+    printf("%12u  %15.1f  %9u  %10.1f  %8u\n", interval_us,
+           static_cast<double>(predicted_error) / queries, predicted_error_max,
+           static_cast<double>(held_error) / queries, held_error_max);
+
+    if (predicted_error >= held_error)
+    {
+        printf("VIOLATION %u us: prediction is less accurate than holding the sample\n", interval_us);
+        return 1;
+    }
+
+    return 0;
+}
+
+// Reads a time stamp in ns and, where available, the time stamp counter
+static void readClock(uint64_t &ns, uint64_t &cycles)
+{
+    ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#ifdef PREDICTOR_HAS_TSC
+    cycles = __rdtsc();
+#else
+    cycles = 0;
+#endif
+}
+
+static void printCost(const char *name, uint64_t ns, uint64_t cycles)
+{
+    printf("%-10s %8.2f ns", name, static_cast<double>(ns) / PREDICTOR_TIMED_CALLS);
+
+    if (cycles > 0)
+    {
+        printf("  %8.2f TSC cycles", static_cast<double>(cycles) / PREDICTOR_TIMED_CALLS);
+    }
+
+    printf("\n");
+}
+
+// Times update() and predict() over the motors of a quad
+static void measureCost(const std::vector<int32_t> &trajectory)
+{
+    DShotErpmPredictor<PREDICTOR_TIMED_MOTORS> erpm_predictor;
+    volatile uint32_t sink = 0;
+    uint64_t start_ns, start_cycles, end_ns, end_cycles;
+
+    readClock(start_ns, start_cycles);
+
+    for (uint32_t call = 0; call < PREDICTOR_TIMED_CALLS; call++)
+    {
+        erpm_predictor.update(call % PREDICTOR_TIMED_MOTORS, trajectory[call % trajectory.size()], call * PREDICTOR_LOOP_US);
+    }
+
+    readClock(end_ns, end_cycles);
+    sink = sink + erpm_predictor.predict(0, 0);
+    printCost("update()", end_ns - start_ns, end_cycles - start_cycles);
+
+    uint32_t erpm_sum = 0;
+    readClock(start_ns, start_cycles);
+
+    for (uint32_t call = 0; call < PREDICTOR_TIMED_CALLS; call++)
+    {
+        erpm_sum += erpm_predictor.predict(call % PREDICTOR_TIMED_MOTORS, call * 7);
+    }
+
+    readClock(end_ns, end_cycles);
+    sink = sink + erpm_sum;
+    printCost("predict()", end_ns - start_ns, end_cycles - start_cycles);
+}
+
+unsigned runPredictorBenchmark(uint32_t seed)
+{
+    const std::vector<int32_t> trajectory = modelTrajectory(seed);
+    unsigned violations = 0;
+
+    printf("DShotRMT %s eRPM predictor, %.0f s of random throttle steps, queried every %d us\n",
+           DSHOT_LIB_VERSION, PREDICTOR_SESSION_US / 1e6, PREDICTOR_LOOP_US);
+    printf("telemetry us  predicted error  max error  held error  max held\n");
+
+    for (const uint32_t interval_us : telemetry_intervals_us)
+    {
+        violations += measureAccuracy(trajectory, interval_us);
+    }
+
+    measureCost(trajectory);
+
+    return violations;
+}
@@ -0,0 +1,21 @@
+//
+// Name:        predictor_benchmark.h
+// Created: 	18.10.2026 16:05:12
+// Author:  	derdoktor667
+//
+// Accuracy and cost of DShotErpmPredictor on the eRPM trajectory of the motor
+// model in VirtualEsc.
+//
+
+#ifndef _PREDICTOR_BENCHMARK_h
+#define _PREDICTOR_BENCHMARK_h
+
+#include <cstdint>
+
+// Prints the prediction error against the modeled eRPM for several telemetry
+// rates, next to holding the last sample, and the time per update() and
+// predict(). Returns the number of violations, a prediction less accurate
+// than holding the last sample.
+unsigned runPredictorBenchmark(uint32_t seed);
+
+#endif
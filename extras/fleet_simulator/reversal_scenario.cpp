@@ -0,0 +1,142 @@
+//
+// Name:        reversal_scenario.cpp
+// Created: 	18.10.2026 16:05:12
+// Author:  	derdoktor667
+//
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <DShotRMT.h>
+#include "host/virtual_rmt.h"
+#include "reversal_scenario.h"
+#include "virtual_esc.h"
+
+constexpr auto REVERSAL_REACHED_PERCENT = 80; // Reversal is done at this share of the reverse speed
+
+// A motor running forward, then asked for reverse
+typedef struct reversal_scenario_s
+{
+    const char *name;
+    virtual_motor_config_t motor;
+    dshot_mode_t mode;
+    uint32_t loop_us;       // Control loop period, one frame and one telemetry sample each
+    int16_t throttle_from;  // Signed 3D throttle before the reversal
+    int16_t throttle_to;    // Signed 3D throttle after the reversal
+    uint32_t settle_us;     // Time at throttle_from
+    uint32_t timeout_us;    // Longest reversal
+} reversal_scenario_t;
+
+// Result of a strategy in a scenario
+typedef struct reversal_result_s
+{
+    uint32_t latency_us;   // From the request to the reverse speed, 0 on a timeout
+    uint32_t desyncs;      // Desyncs of the motor
+    uint32_t hold_frames;  // Neutral frames sent after the request
+} reversal_result_t;
+
+static const reversal_scenario_t reversal_scenarios[] = {
+    // Geared crawler, heavy load and a low desync speed
+    {"crawler", {true, 20000, 150000, 100000, 1500000, 3000, 300000}, DSHOT300, 1000, 400, -400, 1000000, 5000000},
+    // Quad flipping over after a crash, light props spinning down from flight
+    {"turtle", {true, 150000, 40000, 30000, 400000, 8000, 100000}, DSHOT600, 250, 300, -999, 500000, 3000000},
+};
+
+// Runs one scenario, is_erpm_aware sends the reversal with the predicted eRPM
+static reversal_result_t runReversal(const reversal_scenario_t &scenario, bool is_erpm_aware)
+{
+    VirtualEsc esc;
+    VirtualRmt rmt(esc);
+    reversal_result_t result = {};
+
+    rmt.makeCurrent();
+    esc.setMotor(scenario.motor);
+
+    DShotRMT motor(GPIO_NUM_0, RMT_CHANNEL_0);
+    DShotErpmPredictor<1> erpm_predictor;
+    motor.begin(scenario.mode, true);
+
+    const int32_t reached_erpm = static_cast<int32_t>(static_cast<int64_t>(scenario.motor.max_erpm) * abs(scenario.throttle_to) * REVERSAL_REACHED_PERCENT / (DSHOT_3D_THROTTLE_SIGNED_MAX * 100));
+    int32_t last_erpm = 0;
+
+    for (uint32_t time_us = 0; time_us < scenario.settle_us + scenario.timeout_us; time_us += scenario.loop_us)
+    {
+        const bool is_reversing = (time_us >= scenario.settle_us);
+        const int16_t throttle_value = is_reversing ? scenario.throttle_to : scenario.throttle_from;
+
+        // The telemetry of a frame arrives with the next one, the predictor bridges the gap
+        if (time_us > 0)
+        {
+            erpm_predictor.update(0, abs(last_erpm), time_us - scenario.loop_us);
+        }
+
+        if (is_erpm_aware)
+        {
+            motor.sendThrottle3D(throttle_value, erpm_predictor.predict(0, time_us));
+        }
+        else
+        {
+            motor.sendThrottle3D(throttle_value);
+        }
+
+        virtual_esc_frame_t frame;
+
+        if (is_reversing && (esc.takeFrame(frame) == ESC_DECODE_SUCCESS) && (frame.value == DSHOT_CMD_MOTOR_STOP))
+        {
+            result.hold_frames++;
+        }
+
+        last_erpm = esc.getErpm();
+        esc.advance(scenario.loop_us);
+
+        if (is_reversing && (esc.getErpm() <= -reached_erpm))
+        {
+            result.latency_us = time_us + scenario.loop_us - scenario.settle_us;
+            break;
+        }
+    }
+
+    result.desyncs = esc.desyncs;
+    motor.end();
+    VirtualRmt::clearCurrent();
+
+    return result;
+}
+
+unsigned runReversalScenarios()
+{
+    unsigned violations = 0;
+
+    printf("DShotRMT %s reversal latency, %d %% of the reverse speed, threshold %d eRPM\n",
+           DSHOT_LIB_VERSION, REVERSAL_REACHED_PERCENT, DSHOT_3D_REVERSAL_ERPM_DEFAULT);
+    printf("scenario  strategy    latency ms  desyncs  neutral frames\n");
+
+    for (const auto &scenario : reversal_scenarios)
+    {
+        for (const bool is_erpm_aware : {false, true})
+        {
+            const reversal_result_t result = runReversal(scenario, is_erpm_aware);
+
+            printf("%-9s %-11s ", scenario.name, is_erpm_aware ? "eRPM-aware" : "immediate");
+
+            if (result.latency_us > 0)
+            {
+                printf("%10.1f", result.latency_us / 1000.0);
+            }
+            else
+            {
+                printf("%10s", "timeout");
+            }
+
+            printf("  %7u  %14u\n", result.desyncs, result.hold_frames);
+
+            if (is_erpm_aware && ((result.latency_us == 0) || (result.desyncs > 0)))
+            {
+                printf("VIOLATION %s: eRPM-aware reversal %s\n", scenario.name, (result.desyncs > 0) ? "desynced the motor" : "timed out");
+                violations++;
+            }
+        }
+    }
+
+    return violations;
+}
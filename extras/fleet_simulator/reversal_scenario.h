@@ -0,0 +1,18 @@
+//
+// Name:        reversal_scenario.h
+// Created: 	18.10.2026 16:05:12
+// Author:  	derdoktor667
+//
+// Reversal latency of a 3D motor, sending a change of direction right away
+// against holding neutral until the predicted eRPM is low enough.
+//
+
+#ifndef _REVERSAL_SCENARIO_h
+#define _REVERSAL_SCENARIO_h
+
+// Runs the crawler and turtle scenarios and prints the latency and desyncs of
+// both strategies. Returns the number of violations, a desync or a missed
+// reversal of the eRPM-aware strategy.
+unsigned runReversalScenarios();
+
+#endif
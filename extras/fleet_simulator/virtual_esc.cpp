@@ -0,0 +1,219 @@
+//
+// Name:        virtual_esc.cpp
+// Created: 	18.10.2026 16:05:12
+// Author:  	derdoktor667
+//
+
+#include <cmath>
+#include "virtual_esc.h"
+
+VirtualEsc::VirtualEsc()
+    : frames_received(0),
+      desyncs(0),
+      last_decode(ESC_ERR_NO_FRAME),
+      last_frame{},
+      jitter_ticks(0),
+      noise(0),
+      has_motor(false),
+      motor_config{},
+      motor_erpm(0),
+      target_erpm(0),
+      is_driven(false),
+      restart_left_us(0)
+{
+}
+
+void VirtualEsc::setNoise(uint16_t jitter_ticks, uint32_t seed)
+{
+    this->jitter_ticks = jitter_ticks;
+    noise.seed(seed);
+}
+
+void VirtualEsc::setMotor(const virtual_motor_config_t &motor_config)
+{
+    this->motor_config = motor_config;
+    has_motor = true;
+    motor_erpm = 0;
+    target_erpm = 0;
+    is_driven = false;
+    restart_left_us = 0;
+}
+
+void VirtualEsc::advance(uint32_t elapsed_us)
+{
+    if (!has_motor)
+    {
+        return;
+    }
+
+    uint32_t tau_us = motor_config.brake_tau_us;
+    double target = 0;
+
+    if (restart_left_us > 0)
+    {
+        // Desynced, nothing drives or brakes the motor until the restart
+        tau_us = motor_config.coast_tau_us;
+        restart_left_us -= min(restart_left_us, elapsed_us);
+    }
+    else if (is_driven)
+    {
+        // Driving hard against a fast rotation loses the commutation
+        if ((target_erpm * motor_erpm < 0) && (fabs(motor_erpm) > motor_config.desync_erpm))
+        {
+            desyncs++;
+            restart_left_us = motor_config.restart_us;
+            tau_us = motor_config.coast_tau_us;
+        }
+        else
+        {
+            tau_us = motor_config.drive_tau_us;
+            target = target_erpm;
+        }
+    }
+
+    // Exact step of the first-order model, stable for any elapsed time
+    motor_erpm = target + (motor_erpm - target) * exp(-static_cast<double>(elapsed_us) / max(tau_us, 1u));
+}
+
+int32_t VirtualEsc::getErpm() const
+{
+    return static_cast<int32_t>(lround(motor_erpm));
+}
+
+void VirtualEsc::onRmtWrite(rmt_channel_t, const rmt_config_t &config, const rmt_item32_t *items, int item_count)
+{
+    frames_received++;
+    last_decode = decode(config, items, item_count);
+
+    if (has_motor && (last_decode == ESC_DECODE_SUCCESS))
+    {
+        applyThrottle(last_frame.value);
+    }
+}
+
+// Sets the drive of the motor model from a received value, commands leave it as it is
+void VirtualEsc::applyThrottle(uint16_t value)
+{
+    const double max_erpm = motor_config.max_erpm;
+
+    if (value == DSHOT_CMD_MOTOR_STOP)
+    {
+        is_driven = false;
+        target_erpm = 0;
+    }
+    else if (value < DSHOT_THROTTLE_MIN)
+    {
+        return;
+    }
+    else if (!motor_config.is_3d)
+    {
+        is_driven = true;
+        target_erpm = max_erpm * (value - DSHOT_THROTTLE_MIN + 1) / DSHOT_THROTTLE_RANGE;
+    }
+    else if (value <= DSHOT_3D_THROTTLE_REVERSE_MAX)
+    {
+        is_driven = true;
+        target_erpm = -max_erpm * (value - DSHOT_3D_THROTTLE_REVERSE_MIN + 1) / (DSHOT_3D_THROTTLE_REVERSE_MAX - DSHOT_3D_THROTTLE_REVERSE_MIN + 1);
+    }
+    else if (value >= DSHOT_3D_THROTTLE_FORWARD_MIN)
+    {
+        is_driven = true;
+        target_erpm = max_erpm * (value - DSHOT_3D_THROTTLE_FORWARD_MIN + 1) / (DSHOT_3D_THROTTLE_FORWARD_MAX - DSHOT_3D_THROTTLE_FORWARD_MIN + 1);
+    }
+    else
+    {
+        // 1048 is the neutral of the 3D ranges
+        is_driven = false;
+        target_erpm = 0;
+    }
+}
+
+virtual_esc_decode_t VirtualEsc::takeFrame(virtual_esc_frame_t &frame)
+{
+    const virtual_esc_decode_t result = last_decode;
+
+    frame = last_frame;
+    last_decode = ESC_ERR_NO_FRAME;
+
+    return result;
+}
+
+virtual_esc_decode_t VirtualEsc::decode(const rmt_config_t &config, const rmt_item32_t *items, int item_count)
+{
+    // 16 bits and the pause
+    if (item_count != DSHOT_PACKET_LENGTH)
+    {
+        return ESC_ERR_FRAME_LENGTH;
+    }
+
+    last_frame = {};
+    last_frame.is_inverted = (config.tx_config.idle_level == RMT_IDLE_LEVEL_HIGH);
+    last_frame.zero_ticks = 0;
+    last_frame.one_ticks = UINT16_MAX;
+
+    // Every bit starts with the level opposite to the idle level
+    const uint32_t active_level = last_frame.is_inverted ? 0 : 1;
+    std::uniform_int_distribution<int> jitter(-jitter_ticks, jitter_ticks);
+    uint16_t packet = 0;
+
+    for (int i = 0; i < DSHOT_PAUSE_BIT; i++)
+    {
+        if ((items[i].level0 != active_level) || (items[i].level1 == active_level))
+        {
+            return ESC_ERR_BIT_LEVEL;
+        }
+
+        int active_ticks = items[i].duration0;
+        int passive_ticks = items[i].duration1;
+
+        if (jitter_ticks > 0)
+        {
+            active_ticks = max(active_ticks + jitter(noise), 1);
+            passive_ticks = max(passive_ticks + jitter(noise), 1);
+        }
+
+        const int bit_ticks = active_ticks + passive_ticks;
+
+        // Every bit has the length of the first one, give or take the jitter of both
+        if (i == 0)
+        {
+            last_frame.bit_ticks = bit_ticks;
+        }
+        else if (abs(bit_ticks - last_frame.bit_ticks) > (4 * jitter_ticks))
+        {
+            return ESC_ERR_BIT_TIMING;
+        }
+
+        const bool is_one = (2 * active_ticks) > bit_ticks;
+        packet = (packet << 1) | (is_one ? 1 : 0);
+
+        if (is_one)
+        {
+            last_frame.one_ticks = min(last_frame.one_ticks, static_cast<uint16_t>(active_ticks));
+        }
+        else
+        {
+            last_frame.zero_ticks = max(last_frame.zero_ticks, static_cast<uint16_t>(active_ticks));
+        }
+    }
+
+    // Checksum over throttle and telemetric bit, inverted for bidirectional DShot
+    const uint16_t payload = packet >> 4;
+    uint16_t crc = (payload ^ (payload >> 4) ^ (payload >> 8)) & 0x0F;
+
+    if (last_frame.is_inverted)
+    {
+        crc = (~crc) & 0x0F;
+    }
+
+    if (crc != (packet & 0x0F))
+    {
+        return ESC_ERR_CHECKSUM;
+    }
+
+    last_frame.value = payload >> 1;
+    last_frame.telemetric_request = (payload & 1);
+    last_frame.is_command = (last_frame.value < DSHOT_THROTTLE_MIN);
+
+    return ESC_DECODE_SUCCESS;
+}
@@ -0,0 +1,95 @@
+//
+// Name:        virtual_esc.h
+// Created: 	18.10.2026 16:05:12
+// Author:  	derdoktor667
+//
+
+#ifndef _VIRTUAL_ESC_h
+#define _VIRTUAL_ESC_h
+
+#include <random>
+#include <DShotRMT.h>
+#include "host/virtual_rmt.h"
+
+// Result of decoding a frame
+typedef enum virtual_esc_decode_e
+{
+    ESC_DECODE_SUCCESS = 0,
+    ESC_ERR_NO_FRAME,
+    ESC_ERR_FRAME_LENGTH,
+    ESC_ERR_BIT_LEVEL,
+    ESC_ERR_BIT_TIMING,
+    ESC_ERR_CHECKSUM,
+} virtual_esc_decode_t;
+
+// A frame as seen by the ESC
+typedef struct virtual_esc_frame_s
+{
+    uint16_t value;          // 11-bit throttle or command
+    bool telemetric_request; // Telemetric bit
+    bool is_command;         // Values below DSHOT_THROTTLE_MIN are commands
+    bool is_inverted;        // Bidirectional frame, idle level high
+    uint16_t bit_ticks;      // Length of the first bit in RMT ticks
+    uint16_t zero_ticks;     // Longest active pulse decoded as "0"
+    uint16_t one_ticks;      // Shortest active pulse decoded as "1"
+} virtual_esc_frame_t;
+
+// Motor and load driven by the ESC, first-order speed dynamics
+typedef struct virtual_motor_config_s
+{
+    bool is_3d;                // ESC in 3D mode, 0 is neutral, 48 - 1047 reverse, 1049 - 2047 forward
+    int32_t max_erpm;          // eRPM at full throttle
+    uint32_t drive_tau_us;     // Time constant while driven, incl. active braking towards the target
+    uint32_t brake_tau_us;     // Time constant on neutral, braking with brake on stop
+    uint32_t coast_tau_us;     // Time constant after a desync, the motor runs freely
+    int32_t desync_erpm;       // Driving against the rotation above this eRPM desyncs the motor
+    uint32_t restart_us;       // Time the ESC needs to restart a desynced motor
+} virtual_motor_config_t;
+
+// Decodes the RMT items of a DShot frame the way an ESC samples the wire:
+// a bit is "1" when the active pulse is longer than half of the bit. Optional
+// jitter on every pulse simulates a noisy signal line. With a motor attached,
+// every decoded throttle frame drives the motor model.
+class VirtualEsc : public VirtualRmtSink
+{
+public:
+    VirtualEsc();
+
+    // Adds up to jitter_ticks of random jitter to every level, 0 for a clean line.
+    void setNoise(uint16_t jitter_ticks, uint32_t seed);
+
+    // Attaches a motor at standstill, driven by the following throttle frames.
+    void setMotor(const virtual_motor_config_t &motor_config);
+
+    // Runs the motor model for elapsed_us with the last throttle frame.
+    void advance(uint32_t elapsed_us);
+
+    // Returns the signed eRPM of the motor, positive is forward.
+    int32_t getErpm() const;
+
+    void onRmtWrite(rmt_channel_t channel, const rmt_config_t &config, const rmt_item32_t *items, int item_count) override;
+
+    // Returns the decode result of the last frame and clears it.
+    virtual_esc_decode_t takeFrame(virtual_esc_frame_t &frame);
+
+    uint32_t frames_received; // Frames written by the library.
+    uint32_t desyncs;         // Desyncs of the motor.
+
+private:
+    virtual_esc_decode_t decode(const rmt_config_t &config, const rmt_item32_t *items, int item_count);
+    void applyThrottle(uint16_t value);
+
+    virtual_esc_decode_t last_decode; // Result of the last frame.
+    virtual_esc_frame_t last_frame;   // The last frame, valid on ESC_DECODE_SUCCESS.
+    uint16_t jitter_ticks;            // Maximum jitter per level.
+    std::mt19937 noise;               // Random source of the jitter.
+
+    bool has_motor;                      // A motor is attached.
+    virtual_motor_config_t motor_config; // The attached motor.
+    double motor_erpm;                   // Signed speed of the motor.
+    double target_erpm;                  // Signed speed the ESC drives the motor to.
+    bool is_driven;                      // false on neutral.
+    uint32_t restart_left_us;            // Remaining restart time after a desync.
+};
+
+#endif
@@ -0,0 +1,127 @@
+//
+// Name:        work_stealing_pool.h
+// Created: 	18.10.2026 16:05:12
+// Author:  	derdoktor667
+//
+
+#ifndef _WORK_STEALING_POOL_h
+#define _WORK_STEALING_POOL_h
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Runs a fixed set of independent tasks on worker threads. Every worker takes
+// tasks from the back of its own queue and steals from the front of the others
+// once it runs dry, so long sessions do not leave cores idle.
+class WorkStealingPool
+{
+public:
+    explicit WorkStealingPool(unsigned worker_count)
+        : worker_count(worker_count > 0 ? worker_count : 1),
+          steals(0) {}
+
+    // Runs task(worker, task_index) for every task_index below task_count and
+    // returns once all tasks are done.
+    void run(size_t task_count, const std::function<void(unsigned, size_t)> &task)
+    {
+        queues.clear();
+
+        for (unsigned i = 0; i < worker_count; i++)
+        {
+            queues.emplace_back(new worker_queue_t());
+        }
+
+        // Deal the tasks round robin
+        for (size_t i = 0; i < task_count; i++)
+        {
+            queues[i % worker_count]->tasks.push_back(i);
+        }
+
+        std::vector<std::thread> workers;
+
+        for (unsigned worker = 0; worker < worker_count; worker++)
+        {
+            workers.emplace_back([this, worker, &task]()
+                                 {
+                                     size_t task_index;
+
+                                     while (popLocal(worker, task_index) || steal(worker, task_index))
+                                     {
+                                         task(worker, task_index);
+                                     } });
+        }
+
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    unsigned getWorkerCount() const
+    {
+        return worker_count;
+    }
+
+    // Number of tasks taken from another worker's queue.
+    uint64_t getSteals() const
+    {
+        return steals.load();
+    }
+
+private:
+    typedef struct worker_queue_s
+    {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    } worker_queue_t;
+
+    // Takes the newest task of the own queue
+    bool popLocal(unsigned worker, size_t &task_index)
+    {
+        worker_queue_t &queue = *queues[worker];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (queue.tasks.empty())
+        {
+            return false;
+        }
+
+        task_index = queue.tasks.back();
+        queue.tasks.pop_back();
+
+        return true;
+    }
+
+    // Takes the oldest task of the next worker that still has one. No task is
+    // added while running, so a pass without success means all work is taken.
+    bool steal(unsigned thief, size_t &task_index)
+    {
+        for (unsigned i = 1; i < worker_count; i++)
+        {
+            worker_queue_t &queue = *queues[(thief + i) % worker_count];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+
+            if (!queue.tasks.empty())
+            {
+                task_index = queue.tasks.front();
+                queue.tasks.pop_front();
+                steals++;
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    unsigned worker_count;                               // Number of worker threads.
+    std::vector<std::unique_ptr<worker_queue_t>> queues; // One task queue per worker.
+    std::atomic<uint64_t> steals;                        // Tasks taken from another worker.
+};
+
+#endif